@@ -2,21 +2,80 @@
 #define NDEBUG 1
 #endif /* not defined(SEBELEV_MAKSIM_MAKSIMOVICH) and not defined(NDEBUG) */
 
+/* default quantity of threads for Gamer, build with -DWORDLE_THREADS=32 to use idle cores */
+#if not defined(WORDLE_THREADS)
+#define WORDLE_THREADS 1
+#endif /* not defined(WORDLE_THREADS) */
+
+/* gamer, which plays in main: Gamer (min/max), ExpectedSizeGamer, EntropyGamer or HybridGamer */
+#if not defined(WORDLE_GAMER)
+#define WORDLE_GAMER Gamer
+#endif /* not defined(WORDLE_GAMER) */
+
+/* default opening book file for Gamer, build with -DWORDLE_BOOK_PATH='"wordle.book"' to save first guesses */
+#if not defined(WORDLE_BOOK_PATH)
+#define WORDLE_BOOK_PATH ""
+#endif /* not defined(WORDLE_BOOK_PATH) */
+
+/* default lookahead of Gamer: quantity of best guesses, which are checked deeper (0 - disabled),
+   and time budget of one guess, build with -DWORDLE_LOOKAHEAD=16 -DWORDLE_LOOKAHEAD_MS=100 to guess smarter */
+#if not defined(WORDLE_LOOKAHEAD)
+#define WORDLE_LOOKAHEAD 0
+#endif /* not defined(WORDLE_LOOKAHEAD) */
+#if not defined(WORDLE_LOOKAHEAD_MS)
+#define WORDLE_LOOKAHEAD_MS 50
+#endif /* not defined(WORDLE_LOOKAHEAD_MS) */
+
 #include <algorithm>
-#include <bitset>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cctype>
+#include <chrono>
+#include <cerrno>
+#include <cmath>
+#include <concepts>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <initializer_list>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif /* defined(__x86_64__) */
 #include <iostream>
+#include <iterator>
 #include <istream>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <ostream>
+#include <random>
 #include <stdexcept>
+#include <span>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <tuple>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
-#include <list>
 #include <limits>
+#include <numeric>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 //------------------------------------------------------------------------------------------------------------
 
@@ -28,6 +87,107 @@ wrapper on compiler hint, that show, that this condition often (not) performed
 
 //------------------------------------------------------------------------------------------------------------
 
+/* instrumentation of hot paths, build with -DWORDLE_STATS=1 to enable.
+    WORDLE_COUNT(counter, value) adds value to counter, WORDLE_TIMER(counter) adds nanoseconds till end of scope,
+    Game writes counters of every round and of whole game as JSON lines to stderr (stdout is protocol of judge).
+    without WORDLE_STATS macros are empty and arguments are not evaluated, so there is no cost
+*/
+#if defined(WORDLE_STATS)
+
+/* X(name): feedback_evaluations - codes calculated for feedback table, table_reads - codes read by search,
+   guesses_ranked - histograms built, prunes - early exits by bound, candidates_filtered - removed candidates,
+   *_ns - time of gamer startup, of gamer guess, of search in it, of filtering by answer and of waiting for dealer */
+#define WORDLE_STATS_COUNTERS(X) \
+    X(feedback_evaluations) X(table_reads) X(guesses_ranked) X(prunes) X(candidates_filtered) \
+    X(startup_ns) X(guess_ns) X(select_ns) X(filter_ns) X(io_wait_ns)
+
+class Stats
+{
+  public:
+    enum Counter : size_t
+    {
+#       define WORDLE_STATS_ENUM(name) name,
+        WORDLE_STATS_COUNTERS(WORDLE_STATS_ENUM)
+#       undef WORDLE_STATS_ENUM
+        counters_size
+    };
+
+    using Snapshot = std::array<uint64_t, counters_size>;
+
+    /* counters are shared by workers of ThreadPool */
+    static void add(Counter counter, uint64_t value)
+    { counters_[counter].fetch_add(value, std::memory_order_relaxed); }
+
+    static Snapshot snapshot()
+    {
+        Snapshot values;
+        for (size_t it = 0; it < counters_size; ++it)
+            values[it] = counters_[it].load(std::memory_order_relaxed);
+        return values;
+    }
+
+    /* one line {"type": type, fields..., counters since begin...} by one write, so lines are not mixed */
+    static void dump(std::string_view type, std::initializer_list<std::pair<std::string_view, uint64_t>> fields,
+                     const Snapshot &begin)
+    {
+        static constexpr std::string_view names[] = {
+#           define WORDLE_STATS_NAME(name) #name,
+            WORDLE_STATS_COUNTERS(WORDLE_STATS_NAME)
+#           undef WORDLE_STATS_NAME
+        };
+
+        const Snapshot end = snapshot();
+
+        std::string line = "{\"type\":\"" + std::string(type) + "\"";
+        auto&& append = [&line](std::string_view name, uint64_t value)
+        { line.append(",\"").append(name).append("\":").append(std::to_string(value)); };
+
+        for (auto&& [name, value] : fields)
+            append(name, value);
+        for (size_t it = 0; it < counters_size; ++it)
+            append(names[it], end[it] - begin[it]);
+        line.append("}\n");
+
+        std::cerr.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+
+    /* adds lifetime of object in nanoseconds to counter */
+    class ScopedTimer
+    {
+      private:
+        Counter counter_;
+        std::chrono::steady_clock::time_point started_;
+
+      public:
+        explicit ScopedTimer(Counter counter) : counter_(counter), started_(std::chrono::steady_clock::now())
+        {}
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+        ~ScopedTimer()
+        {
+            const auto elapsed = std::chrono::steady_clock::now() - started_;
+            add(counter_, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+    };
+
+  private:
+    static inline std::array<std::atomic<uint64_t>, counters_size> counters_{};
+};
+
+#define WORDLE_COUNT(counter, value) Stats::add(Stats::counter, (value))
+#define WORDLE_TIMER(counter) const Stats::ScopedTimer wordle_timer_##counter{Stats::counter}
+
+#else /* defined(WORDLE_STATS) */
+
+#define WORDLE_COUNT(counter, value) ((void)0)
+#define WORDLE_TIMER(counter) ((void)0)
+
+#endif /* defined(WORDLE_STATS) */
+
+//------------------------------------------------------------------------------------------------------------
+
 /* concepts for type, which have operator>> for std::istream */
 template <typename T>
 concept Readable = requires(T t, std::istream is) { { is >> t }; };
@@ -40,8 +200,22 @@ concept Writable = requires(T t, std::ostream os) { { os << t }; };
 
 //------------------------------------------------------------------------------------------------------------
 
-/* helper function, to read from std::istream immediately in variable */
-template <Readable T> T read(std::istream &is) { T tmp; is >> tmp; return tmp; }
+/* helper function, to read from std::istream (or dealer) immediately in variable */
+template <typename T, typename source_t> T read(source_t &source) { T tmp; source >> tmp; return tmp; }
+
+//------------------------------------------------------------------------------------------------------------
+
+/* concept IDealer show interface of transport between game and dealer:
+    requests (guesses) are written by operator<<, and sent to dealer by flush(),
+    game parametrs and answers are read by operator>> */
+template <typename T>
+concept IDealer = requires(T dealer, std::string_view request, size_t number, std::string word) {
+    { dealer << request };
+    { dealer << '\n' };
+    { dealer >> number };
+    { dealer >> word };
+    { dealer.flush() };
+};
 
 //------------------------------------------------------------------------------------------------------------
 
@@ -70,29 +244,193 @@ class Dealer
 
     template <Readable read_t> void operator>>(read_t &answer)
     { answers_ >> answer; }
+
+    void flush() { requests_.flush(); }
 };
 
 //------------------------------------------------------------------------------------------------------------
 
-/* class Dictionary
-    wrapper of std::vector<std::string> for owning of game words
-    is constructible by (size_t, Dealer&)
-    have operator[] to get words, method size()
+/* class FdDealer
+    same as Dealer, but over file descriptors with own buffers and raw read(2)/write(2):
+    no iostreams formatting, and only one write(2) on flush().
+    is constructible with (int requests_fd, int answers_fd)
+    also can read all words of dictionary directly in arena of Dictionary
 */
+class FdDealer
+{
+  private:
+    static constexpr size_t input_buffer_size = 1 << 16;
+
+    int requests_fd_;
+    int answers_fd_;
+
+    std::unique_ptr<char[]> input_;
+    size_t input_begin_ = 0;
+    size_t input_end_ = 0;
+
+    std::string output_;
+
+    /* false - end of input */
+    bool fill()
+    {
+        input_begin_ = input_end_ = 0;
+        for (;;)
+        {
+            const ssize_t got = ::read(answers_fd_, input_.get(), input_buffer_size);
+            if (likely(got > 0)) { input_end_ = static_cast<size_t>(got); return true; }
+            if (got == 0) return false;
+            if (errno != EINTR) throw std::runtime_error("Cannot read from dealer: " + std::string(std::strerror(errno)));
+        }
+    }
+
+    /* next not space char, than it is first char of input */
+    void skip_spaces()
+    {
+        for (;;)
+        {
+            for (; input_begin_ < input_end_; ++input_begin_)
+                if (not std::isspace(static_cast<unsigned char>(input_[input_begin_]))) return;
+
+            if (unlikely(not fill()))
+                throw std::runtime_error("Unexpected end of dealer input.");
+        }
+    }
+
+    /* append chars of token to word, token can be splitted between buffers */
+    template <typename consumer_t> void read_token(consumer_t &&consume)
+    {
+        skip_spaces();
+        for (;;)
+        {
+            size_t end = input_begin_;
+            while (end < input_end_ and not std::isspace(static_cast<unsigned char>(input_[end])))
+                ++end;
+
+            consume(std::string_view{input_.get() + input_begin_, end - input_begin_});
+            input_begin_ = end;
+
+            if (input_begin_ < input_end_ or not fill()) return;
+        }
+    }
+
+  public:
+    explicit FdDealer(int requests_fd, int answers_fd)
+        : requests_fd_(requests_fd), answers_fd_(answers_fd), input_(std::make_unique<char[]>(input_buffer_size))
+    {}
+
+    FdDealer &operator<<(std::string_view request) { output_.append(request); return *this; }
+    FdDealer &operator<<(char request) { output_.push_back(request); return *this; }
+
+    void operator>>(std::string &answer)
+    {
+        answer.clear();
+        read_token([&answer](std::string_view part) { answer.append(part); });
+    }
+
+    void operator>>(size_t &number)
+    {
+        number = 0;
+        bool digits = false;
+        read_token([&](std::string_view part)
+        {
+            for (auto&& c : part)
+            {
+                if (unlikely(c < '0' or c > '9'))
+                    throw std::runtime_error("Expected number (dealer bug): '" + std::string(part) + "'");
+                if (unlikely(__builtin_mul_overflow(number, size_t{10}, &number) or
+                             __builtin_add_overflow(number, static_cast<size_t>(c - '0'), &number)))
+                    throw std::runtime_error("Too big number (dealer bug).");
+                digits = true;
+            }
+        });
+
+        if (unlikely(not digits))
+            throw std::runtime_error("Expected number (dealer bug).");
+    }
+
+    /* words of same size are copied to arena one after another, without separators */
+    void read_words(char *arena, size_t n_words, size_t words_size)
+    {
+        for (size_t it = 0; it < n_words; ++it, arena += words_size)
+        {
+            size_t size = 0;
+            read_token([&](std::string_view part)
+            {
+                if (unlikely(size + part.size() > words_size))
+                    throw std::runtime_error("Invalid word size (dealer bug).");
+                std::copy(part.begin(), part.end(), arena + size);
+                size += part.size();
+            });
+
+            if (unlikely(size != words_size))
+                throw std::runtime_error("Invalid word size (dealer bug).");
+        }
+    }
+
+    void flush()
+    {
+        for (size_t written = 0; written < output_.size();)
+        {
+            const ssize_t put = ::write(requests_fd_, output_.data() + written, output_.size() - written);
+            if (likely(put >= 0)) { written += static_cast<size_t>(put); continue; }
+            if (errno != EINTR) throw std::runtime_error("Cannot write to dealer: " + std::string(std::strerror(errno)));
+        }
+
+        output_.clear();
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------
+
+static_assert(IDealer<Dealer>, "class Dealer must realized IDealer interface.");
+static_assert(IDealer<FdDealer>, "class FdDealer must realized IDealer interface.");
+
+//------------------------------------------------------------------------------------------------------------
 
-class Dictionary : public std::vector<std::string>
+/* class Dictionary
+    owner of game words: all words have the same size, so they are stored one after another in one arena
+    is constructible by (size_t n_words, size_t words_size, dealer_t&)
+    have operator[] to get words (std::string_view), method size()
+*/
+class Dictionary
 {
-//   public:
-//     using std::vector<std::string>::operator[];
-//     using std::vector<std::string>::begin;
-//     using std::vector<std::string>::end;
-//     using std::vector<std::string>::size;
+  private:
+    size_t size_;
+    size_t words_size_;
+    std::string arena_;
+
   public:
-    /* implicit */ Dictionary(size_t n_words, Dealer &dealer) : std::vector<std::string>(n_words)
+    template <IDealer dealer_t>
+    Dictionary(size_t n_words, size_t words_size, dealer_t &dealer)
+        : size_(n_words), words_size_(words_size), arena_(n_words * words_size, '\0')
     {
+        /* transport can fill arena by itself */
+        if constexpr (requires { dealer.read_words(arena_.data(), n_words, words_size); })
+        {
+            dealer.read_words(arena_.data(), n_words, words_size);
+            return;
+        }
+
+        /* one buffer for all words */
+        std::string word;
+        word.reserve(words_size_);
         for (size_t it = 0; it < n_words; ++it)
-            dealer >> (*this)[it];
+        {
+            dealer >> word;
+            if (unlikely(word.size() != words_size_))
+                throw std::runtime_error("Invalid word size (dealer bug): '" + word + "'");
+
+            std::copy(word.begin(), word.end(), arena_.data() + it * words_size_);
+        }
     }
+
+    std::string_view operator[](size_t it) const { return {arena_.data() + it * words_size_, words_size_}; }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    /* all words without separators */
+    std::string_view arena() const { return arena_; }
 };
 
 //------------------------------------------------------------------------------------------------------------
@@ -103,6 +441,9 @@ class Dictionary : public std::vector<std::string>
 struct GameParams
 {
   private:
+    /* answer can be only one of the first 2000 words - global game rules these are too */
+    static constexpr size_t max_answers_size = 2000;
+
     size_t dictionary_size_;
 
   public:
@@ -110,11 +451,15 @@ struct GameParams
     size_t words_size;
     size_t attempts;
     Dictionary dictionary;
+    /* answers universe: words [0, answers_size) of dictionary, guesses are still all dictionary words */
+    size_t answers_size;
 
-    explicit GameParams(Dealer &dealer)
+    template <IDealer dealer_t>
+    explicit GameParams(dealer_t &dealer)
         : dictionary_size_(read<size_t>(dealer)), rounds(read<size_t>(dealer)), words_size(read<size_t>(dealer)),
           attempts(6), /* 6 atts - global game rules these are */
-          dictionary(dictionary_size_, dealer)
+          dictionary(dictionary_size_, words_size, dealer),
+          answers_size(std::min(dictionary_size_, max_answers_size))
     {
     }
 };
@@ -137,14 +482,62 @@ concept IGamer = std::is_constructible_v<T, GameParams> && requires(T gamer, std
 
 //------------------------------------------------------------------------------------------------------------
 
-/* class Gamer
-   realization of concept IGamer
-   using min/max strategy
+/* struct PackedWord
+    word, packed in one uint64_t: i-th letter is 5-bit code (letter - 'a') in bits [5 * i, 5 * i + 5),
+    and quantities of every letter in word.
+    is constructible by (std::string_view word, size_t words_size)
 */
-class Gamer
+struct PackedWord
 {
-  private:
     static constexpr size_t english_alphabet_size = 26;
+    static constexpr size_t letter_bits = 5;
+    static constexpr uint64_t letter_mask = (uint64_t{1} << letter_bits) - 1;
+    /* 12 letters * 5 bits = 60 bits */
+    static constexpr size_t max_size = 64 / letter_bits;
+
+    using LetterCounts = std::array<uint8_t, english_alphabet_size>;
+
+    uint64_t letters = 0;
+    LetterCounts counts = {};
+
+    PackedWord(std::string_view word, size_t words_size)
+    {
+        if (unlikely(word.size() != words_size or words_size > max_size))
+            throw std::runtime_error("Invalid word (dealer bug): '" + std::string(word) + "'");
+
+        for (size_t i = 0; i < words_size; ++i)
+        {
+            if (unlikely(word[i] < 'a' or word[i] > 'z'))
+                throw std::runtime_error("Invalid letter in word (dealer bug): '" + std::string(word) + "'");
+
+            const uint8_t letter = static_cast<uint8_t>(word[i] - 'a');
+            letters |= uint64_t{letter} << (letter_bits * i);
+            ++counts[letter];
+        }
+    }
+
+    /* i-th 5-bit field of packed letters */
+    static uint8_t field(uint64_t packed, size_t i)
+    { return static_cast<uint8_t>((packed >> (letter_bits * i)) & letter_mask); }
+
+    uint8_t letter(size_t i) const { return field(letters, i); }
+};
+
+//------------------------------------------------------------------------------------------------------------
+
+/* class FeedbackTable
+    precomputed dealer answers for every pair (guess, actual), guess - any dictionary word, actual - any answer.
+    hint '#?-' is encoded as base-3 integer: '-' = 0, '?' = 1, '#' = 2, first letter is the lowest digit,
+    so there are 3^L different codes, and filtering of words is comparing of two integers.
+    is constructible by (const GameParams&)
+*/
+class FeedbackTable
+{
+  public:
+    using Code = uint16_t;
+
+    /* 3^10 = 59049 is the last power of 3, which fits in Code */
+    static constexpr size_t max_words_size = 10;
 
   private:
     /* status of letter in guessed word */
@@ -155,422 +548,2350 @@ class Gamer
         CORRECT = '#'
     };
 
-  private:
-
+    /* digits of letter statuses in code */
+    static constexpr Code no_digit = 0;
+    static constexpr Code wrong_position_digit = 1;
+    static constexpr Code correct_digit = 2;
 
   private:
-    /* imlp word representation */
-    using Word = std::string;
+    size_t words_size_;
+    size_t answers_size_;
+    size_t codes_size_;
+    std::vector<Code> codes_; /* guesses x answers, row by guess */
 
-    /* estimation result */
-    struct WordHint : public std::vector<LetterStatus>
+    /* char to letter status digit */
+    static Code char_to_digit(char c)
     {
-      private:
-        /* char to letter status */
-        LetterStatus char_to_status(char c) const
-        {
-            switch (c)
-            {
-                case '-': return NO;
-                case '?': return WRONG_POSITION;
-                case '#': return CORRECT;
-                default: throw std::runtime_error("Invalid letter status (dealer bug): '"+std::string(1, c)+"'");
-            }
-            __builtin_unreachable();
-        }
-
-      public:
-        
-        WordHint(size_t size) : std::vector<LetterStatus>(size, NO) {}
-
-        WordHint(std::string_view answer) : std::vector<LetterStatus>(answer.size())
+        switch (c)
         {
-            for (size_t it = 0, ite = answer.size(); it < ite; ++it)
-                (*this)[it] = char_to_status(answer[it]);
+            case NO: return no_digit;
+            case WRONG_POSITION: return wrong_position_digit;
+            case CORRECT: return correct_digit;
+            default: throw std::runtime_error("Invalid letter status (dealer bug): '"+std::string(1, c)+"'");
         }
-    };
+        __builtin_unreachable();
+    }
 
-    /* range guesses */
-    struct GuessRanking
+    /* same rules as dealer has: '#' first, then '?' from left to right, every actual letter can be used once.
+       fixed_words_size != 0 - loops bounds are known in compile time (specialization for common L),
+       fixed_words_size == 0 - generic version with runtime words_size */
+    template <size_t fixed_words_size>
+    static Code evaluate_guess(const PackedWord &guess, const PackedWord &actual, size_t words_size)
     {
-        unsigned int max_score_ = std::numeric_limits<decltype(max_score_)>::max();;
-        unsigned int average_score_ = 0;
-        unsigned int best_score_ = std::numeric_limits<decltype(best_score_)>::max();
-        size_t index_ = 0;
-
-        bool operator<(const GuessRanking& rhs) const
-        {
-            if (max_score_ < rhs.max_score_) return true;
-            if (max_score_ > rhs.max_score_) return false;
-
-            if (average_score_ < rhs.average_score_) return true;
-            if (average_score_ > rhs.average_score_) return false;
-
-            if (best_score_ < rhs.best_score_) return true;
-            if (best_score_ > rhs.best_score_) return false;
-
-            return index_ < rhs.index_;
-        }
-    };
-
-  private:
-    /* reference on game parametrs :) */
-    const GameParams &params_;
-
-    /* suitable words on every step */
-    // std::vector<bool> possible_words_;  /* not a bitser, `cause we will know size only in runtine */
-    std::list<Word> possible_words_;
+        if constexpr (fixed_words_size != 0)
+            words_size = fixed_words_size;
 
-    /* save best_word_for_begin_ for all rounds */
-    Word best_word_for_begin_;
-    Word last_guess_;
-
-    WordHint evaluate_guess(const Word& guess, const Word& actual) const
-    {
-        WordHint result(params_.words_size);
-        Word actual_copy = actual;
+        /* not used letters of actual */
+        PackedWord::LetterCounts counts = actual.counts;
 
-        constexpr char used = 0;
+        /* zero 5-bit field in xor - exact match */
+        const uint64_t diff = guess.letters ^ actual.letters;
+        uint8_t exact[PackedWord::max_size];
 
         /* exact matches */
-        for (size_t i = 0; i < params_.words_size; ++i)
+        for (size_t i = 0; i < words_size; ++i)
         {
-            if (guess[i] != actual_copy[i]) continue;
-            result[i] = CORRECT;
-            actual_copy[i] = used; /* mark as used */
+            exact[i] = (PackedWord::field(diff, i) == 0);
+            counts[guess.letter(i)] -= exact[i];
         }
 
-        for (size_t i = 0; i < params_.words_size; ++i)
+        /* '?' from left to right, while actual has not used such letters */
+        Code code = 0;
+        Code power = 1;
+        for (size_t i = 0; i < words_size; ++i, power = static_cast<Code>(power * 3))
         {
-            if (result[i] == CORRECT) continue;
-            for (size_t j = 0; j < params_.words_size; ++j)
-            {
-                if (guess[i] != actual_copy[j]) continue;
-                result[i] = WRONG_POSITION;
-                actual_copy[j] = used; /* mark as used */
-                break;
-            }
+            const uint8_t letter = guess.letter(i);
+            const uint8_t wrong_position = (not exact[i]) & (counts[letter] != 0);
+            counts[letter] -= wrong_position;
+            code = static_cast<Code>(code + (exact[i] * correct_digit + wrong_position * wrong_position_digit) * power);
         }
 
-        return result;
+        return code;
     }
 
-    bool is_word_possible(const WordHint& hint, const Word& guess, Word word) const
+#if defined(__x86_64__)
+    /* answers are scored by 16 at once, one 16-bit lane per answer */
+    static constexpr size_t avx2_lanes = 16;
+
+    /* same rules as evaluate_guess, but one guess against 16 answers.
+       letters of answers are stored by positions: letters[position * stride + answer].
+       '?' for i-th letter of guess: actual has more not exactly matched such letters,
+       than guess has not exactly matched such letters before i */
+    __attribute__((target("avx2")))
+    void fill_rows_avx2(const std::vector<PackedWord> &words, const std::vector<uint8_t> &letters, size_t stride)
     {
-        /* check '#' */
-        for (size_t i = 0; i < params_.words_size; ++i)
-        {
-            if (hint[i] != CORRECT) continue;
-            if (guess[i] != word[i]) return false;
-            word[i] = 0; /* for ? */
-        }
+        __m256i actual[PackedWord::max_size];
+        __m256i exact[PackedWord::max_size];
+        alignas(32) Code chunk[avx2_lanes];
 
-        /* check '?' */
-        for (size_t i = 0; i < params_.words_size; ++i)
+        for (size_t guess = 0, guesses_size = words.size(); guess < guesses_size; ++guess)
         {
-            if (hint[i] != WRONG_POSITION) continue;
+            const PackedWord &packed = words[guess];
+            Code *row = codes_.data() + guess * answers_size_;
 
-            if (guess[i] == word[i]) return false;
-
-            bool found = false;
-            for (size_t j = 0; j < params_.words_size; ++j)
+            for (size_t first = 0; first < answers_size_; first += avx2_lanes)
             {
-                if (guess[i] != word[j]) continue;
-
-                found = true;
-                word[j] = 0;
-                break;
-            }
+                for (size_t j = 0; j < words_size_; ++j)
+                {
+                    const auto *src = reinterpret_cast<const __m128i *>(letters.data() + j * stride + first);
+                    actual[j] = _mm256_cvtepu8_epi16(_mm_loadu_si128(src));
+                    exact[j] = _mm256_cmpeq_epi16(actual[j], _mm256_set1_epi16(packed.letter(j)));
+                }
 
-            if (found) continue;
-            return false;
-        }
+                __m256i code = _mm256_setzero_si256();
+                Code power = 1;
+                for (size_t i = 0; i < words_size_; ++i, power = static_cast<Code>(power * 3))
+                {
+                    const uint8_t letter = packed.letter(i);
+                    const __m256i guess_letter = _mm256_set1_epi16(letter);
+
+                    /* mask is -1, so subtraction of mask is increment */
+                    __m256i available = _mm256_setzero_si256();
+                    for (size_t j = 0; j < words_size_; ++j)
+                    {
+                        const __m256i same = _mm256_cmpeq_epi16(actual[j], guess_letter);
+                        available = _mm256_sub_epi16(available, _mm256_andnot_si256(exact[j], same));
+                    }
+
+                    __m256i used_before = _mm256_setzero_si256();
+                    for (size_t k = 0; k < i; ++k)
+                    {
+                        if (packed.letter(k) != letter) continue;
+                        used_before = _mm256_sub_epi16(used_before, _mm256_andnot_si256(exact[k], _mm256_set1_epi16(-1)));
+                    }
+
+                    const __m256i wrong_position = _mm256_andnot_si256(exact[i], _mm256_cmpgt_epi16(available, used_before));
+
+                    code = _mm256_add_epi16(code, _mm256_and_si256(exact[i], _mm256_set1_epi16(static_cast<short>(correct_digit * power))));
+                    code = _mm256_add_epi16(code, _mm256_and_si256(wrong_position, _mm256_set1_epi16(static_cast<short>(wrong_position_digit * power))));
+                }
 
-        /* check '-' */
-        for (size_t i = 0; i < params_.words_size; ++i)
-        {
-            if (hint[i] != NO) continue;
-            for (size_t j = 0; j < params_.words_size; ++j)
-            {
-                if (guess[i] != word[j]) continue;
-                return false;
+                _mm256_store_si256(reinterpret_cast<__m256i *>(chunk), code);
+                std::copy_n(chunk, std::min(avx2_lanes, answers_size_ - first), row + first);
             }
         }
-
-        return true;
     }
+#endif /* defined(__x86_64__) */
 
-    size_t count_filtered_words(const WordHint& hint, const Word& guess) const
+    /* all rows with compile-time words size */
+    template <size_t fixed_words_size>
+    void fill_rows(const std::vector<PackedWord> &words)
     {
-        size_t count = 0;
-        for (auto&& word: possible_words_)
+        for (size_t guess = 0, guesses_size = words.size(); guess < guesses_size; ++guess)
         {
-            if (not is_word_possible(hint, guess, word)) continue;
-            ++count;
+            Code *row = codes_.data() + guess * answers_size_;
+            for (size_t actual = 0; actual < answers_size_; ++actual)
+                row[actual] = evaluate_guess<fixed_words_size>(words[guess], words[actual], words_size_);
         }
-
-        return count;
     }
 
-    void filter_possible_words(const Word& guess, const WordHint& hint)
+  public:
+    explicit FeedbackTable(const GameParams &params)
+        : words_size_(params.words_size), answers_size_(params.answers_size), codes_size_(1)
     {
-        for (auto it = possible_words_.begin(), ite = possible_words_.end(); it != ite; /* is_possible(it) ? (++it) : (it = erase(it) */)
-        {
-            if (is_word_possible(hint, guess, *it))
-            { ++it; continue; }
-            it = possible_words_.erase(it);
-        }
-    }
+        if (unlikely(words_size_ > max_words_size))
+            throw std::runtime_error("Too long words for feedback table: " + std::to_string(words_size_));
 
-    /* min/max strategy */
-    Word select_best_guess_minmax() const
-    {
-        /* if remaines 1 word -> return it*/
-        if (unlikely(possible_words_.size() == 1))
-            return possible_words_.front();
+        for (size_t it = 0; it < words_size_; ++it)
+            codes_size_ *= 3;
 
-        GuessRanking best_ranking;
-        best_ranking.max_score_ = std::numeric_limits<decltype(best_ranking.max_score_)>::max();
-        best_ranking.average_score_ = 0;
-        best_ranking.best_score_ = std::numeric_limits<decltype(best_ranking.best_score_)>::max();
-        best_ranking.index_ = 0;
+        std::vector<PackedWord> words;
+        words.reserve(params.dictionary.size());
+        for (size_t it = 0, ite = params.dictionary.size(); it < ite; ++it)
+            words.emplace_back(params.dictionary[it], words_size_);
 
-        /* iterate by guesses */
-        for (size_t it = 0, ite = params_.dictionary.size(); it < ite; ++it)
+        codes_.resize(words.size() * answers_size_);
+        WORDLE_COUNT(feedback_evaluations, codes_.size());
+
+#if defined(__x86_64__) and not defined(WORDLE_NO_AVX2)
+        /* codes fit in 16-bit signed lanes (3^9 < 2^15), letters of answers are transposed for vector loads */
+        if (words_size_ < max_words_size and __builtin_cpu_supports("avx2"))
         {
-            auto&& guess = params_.dictionary[it];
+            const size_t stride = (answers_size_ + avx2_lanes - 1) / avx2_lanes * avx2_lanes;
+            std::vector<uint8_t> letters(words_size_ * stride, static_cast<uint8_t>(PackedWord::letter_mask));
+            for (size_t actual = 0; actual < answers_size_; ++actual)
+                for (size_t j = 0; j < words_size_; ++j)
+                    letters[j * stride + actual] = words[actual].letter(j);
+
+            fill_rows_avx2(words, letters, stride);
+            return;
+        }
+#endif /* defined(__x86_64__) and not defined(WORDLE_NO_AVX2) */
 
-            GuessRanking ranking
-            {
-                .max_score_ = 0,
-                .average_score_ = 0,
-                .best_score_ = std::numeric_limits<decltype(ranking.best_score_)>::max(),
-                .index_ = it,
-            };
-
-            bool early_exit = false;
-            
-            for (auto&& actual : possible_words_)
-            {
-                if (likely(guess != actual))
-                {
-                    auto&& hint = evaluate_guess(guess, actual);
-                    decltype(ranking.max_score_) score = count_filtered_words(hint, guess);
-                    if (score == 0) score = possible_words_.size();
+        switch (words_size_)
+        {
+            case 4: fill_rows<4>(words); break;
+            case 5: fill_rows<5>(words); break;
+            case 6: fill_rows<6>(words); break;
+            case 7: fill_rows<7>(words); break;
+            case 8: fill_rows<8>(words); break;
+            default: fill_rows<0>(words); break;
+        }
+    }
 
-                    ranking.average_score_ += score;
-                    ranking.max_score_ = std::max(score, ranking.max_score_);
-                    ranking.best_score_ = std::min(score, ranking.best_score_);
-                }
-                else
-                    ranking.best_score_ = 0;
+    /* quantity of different codes (3^L) */
+    size_t codes_size() const { return codes_size_; }
 
-                if (ranking.max_score_ <= best_ranking.max_score_) continue;
+    /* code of "##...#" answer */
+    Code all_correct() const { return static_cast<Code>(codes_size_ - 1); }
 
-                early_exit = true;
-                break;
-            }
+    /* codes of guess against all answers */
+    const Code *row(size_t guess) const { return codes_.data() + guess * answers_size_; }
 
-            if (early_exit) continue;
+    Code operator()(size_t guess, size_t actual) const { return row(guess)[actual]; }
 
-            /* compare with best */
-            if (ranking < best_ranking)
-                best_ranking = ranking;
+    /* dealer answer to code */
+    Code encode(std::string_view answer) const
+    {
+        if (unlikely(answer.size() != words_size_))
+            throw std::runtime_error("Invalid answer size (dealer bug): '" + std::string(answer) + "'");
 
-            if (best_ranking.max_score_ == 1) break;
-        }
+        Code code = 0;
+        for (size_t i = words_size_; i-- > 0;)
+            code = static_cast<Code>(code * 3 + char_to_digit(answer[i]));
 
-        return params_.dictionary[best_ranking.index_];
+        return code;
     }
-    
-    /* select first word with max unique lettetrs quantity */
-    Word get_first_guess()
-    {
-        if (unlikely(params_.dictionary.empty()))
-            throw std::runtime_error("Given no words.");
-
-        const bool first_call = last_guess_.empty();
+};
 
-        if (likely(not first_call))
-            return best_word_for_begin_;
+//------------------------------------------------------------------------------------------------------------
 
-        Word best_word = params_.dictionary[0];
-        size_t best_unique = 0;
+/* class OpeningBook
+    precomputed first guesses of round: tree opener -> dealer answer code -> next guess -> ..., depth levels of guesses.
+    tree is keyed by hash of dictionary and can be saved in binary file, which is mapped in memory at next start,
+    so guesses from book cost O(log(children)) instead of min/max.
+    file: Header, nodes[nodes_size], edges[edges_size]; children of node are edges [first_edge, first_edge + children_size),
+    which are sorted by code.
+*/
+class OpeningBook
+{
+  public:
+    static constexpr size_t no_node = std::numeric_limits<size_t>::max();
 
-        for (auto&& word: params_.dictionary)
-        {
-            std::bitset<english_alphabet_size> seen(false);
-            size_t unique_letters = 0;
+  private:
+    static constexpr char magic[8] = {'W', 'R', 'D', 'L', 'B', 'O', 'O', 'K'};
+    static constexpr uint32_t version = 1;
 
-            for (auto&& letter : word)
-            {
-                size_t i = static_cast<size_t>(letter - 'a');
-                if (seen[i]) continue;
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t depth;
+        uint64_t dictionary_hash;
+        uint64_t nodes_size;
+        uint64_t edges_size;
+    };
 
-                seen[i] = true;
-                ++unique_letters;
-            }
-#           define лолкек 666
-            if (unique_letters <= best_unique) continue;
+    struct Node
+    {
+        uint32_t guess;
+        uint32_t first_edge;
+        uint32_t children_size;
+    };
 
-            best_unique = unique_letters;
-            best_word = word;
+    struct Edge
+    {
+        FeedbackTable::Code code;
+        uint16_t reserved; /* explicit padding, so file has no garbage bytes */
+        uint32_t node;
+    };
 
-            /* we cannot improve this result */
-            if (best_unique == params_.words_size) break;
-        }
+    static_assert(std::is_trivially_copyable_v<Header> and std::is_trivially_copyable_v<Node> and
+                  std::is_trivially_copyable_v<Edge>, "book is saved as raw memory");
 
-        if (unlikely(first_call))
-            best_word_for_begin_ = best_word;
+  private:
+    /* built in this process */
+    std::vector<Node> built_nodes_;
+    std::vector<Edge> built_edges_;
 
-        return best_word;
-    }
+    /* mapped file */
+    void *mapping_ = nullptr;
+    size_t mapping_size_ = 0;
 
-  public:
-    explicit Gamer(const GameParams &params) 
-        : params_(params), possible_words_(params.dictionary.begin(), params_.dictionary.end())
-    {}
+    /* view on built or mapped tree */
+    std::span<const Node> nodes_;
+    std::span<const Edge> edges_;
 
-    /* IGamer interface function */
-    std::string_view try_guess_word()
+    void unmap()
     {
-        if (unlikely(last_guess_.empty())) /* first attempt */
-            last_guess_ = get_first_guess();
-        else
-            last_guess_ = select_best_guess_minmax(); /* select best word from point of view Min/Max strategy */        
+        if (mapping_ != nullptr)
+            munmap(mapping_, mapping_size_);
 
-        return last_guess_;
+        mapping_ = nullptr;
+        mapping_size_ = 0;
     }
 
-    /* IGamer interface function */
-    void become_answer(std::string_view answer)
+  public:
+    OpeningBook() = default;
+    OpeningBook(const OpeningBook &) = delete;
+    OpeningBook &operator=(const OpeningBook &) = delete;
+    ~OpeningBook() { unmap(); }
+
+    /* FNV-1a of everything, what changes guesses: lookahead too, so book of other lookahead is not reused
+       (budget matters only, when lookahead is enabled) */
+    static uint64_t dictionary_hash(const GameParams &params, size_t depth, std::string_view strategy,
+                                    size_t lookahead_width, std::chrono::milliseconds lookahead_budget)
     {
-        WordHint hint{answer};
-        /* filter words by last attempt result */
-        filter_possible_words(last_guess_, hint);
-        /* can use .back(), because was at least 1 request if we become answer */
+        uint64_t hash = 14695981039346656037ull;
+        auto&& mix = [&hash](uint64_t value)
+        {
+            for (size_t byte = 0; byte < sizeof(value); ++byte, value >>= 8)
+                hash = (hash ^ (value & 0xff)) * 1099511628211ull;
+        };
+
+        mix(params.words_size);
+        mix(params.answers_size);
+        mix(depth);
+        mix(lookahead_width);
+        if (lookahead_width != 0)
+            mix(static_cast<uint64_t>(lookahead_budget.count()));
+        for (auto&& letter : strategy)
+            mix(static_cast<unsigned char>(letter));
+        mix(params.dictionary.size());
+        for (auto&& letter : params.dictionary.arena())
+            mix(static_cast<unsigned char>(letter));
+
+        return hash;
     }
 
-    /* IGamer interface function */
+    bool empty() const { return nodes_.empty(); }
+
+    size_t root() const { return empty() ? no_node : 0; }
+
+    size_t guess(size_t node) const { return nodes_[node].guess; }
+
+    /* next node after dealer answer on node guess, no_node if book does not know this position */
+    size_t child(size_t node, FeedbackTable::Code code) const
+    {
+        if (node == no_node) return no_node;
+
+        const Node &parent = nodes_[node];
+        auto first = edges_.begin() + parent.first_edge, last = first + parent.children_size;
+        auto it = std::lower_bound(first, last, code, [](const Edge &edge, FeedbackTable::Code value) { return edge.code < value; });
+
+        return (it != last and it->code == code) ? it->node : no_node;
+    }
+
+    /* breadth-first build, select(candidates, guesses) -> guess for these candidates after guesses of round */
+    template <typename select_t>
+    void build(const FeedbackTable &feedback, size_t answers_size, size_t depth, select_t &&select)
+    {
+        unmap();
+        built_nodes_.clear();
+        built_edges_.clear();
+
+        if (depth == 0 or answers_size == 0) return;
+
+        struct Position
+        {
+            size_t node;
+            size_t level;
+            std::vector<uint32_t> candidates;
+        };
+
+        std::deque<Position> queue;
+        std::vector<uint32_t> all(answers_size);
+        std::iota(all.begin(), all.end(), 0);
+
+        built_nodes_.push_back({static_cast<uint32_t>(select(std::span<const uint32_t>{all}, size_t{0})), 0, 0});
+        queue.push_back({0, 1, std::move(all)});
+
+        std::vector<std::pair<FeedbackTable::Code, uint32_t>> coded;
+        for (; not queue.empty(); queue.pop_front())
+        {
+            Position &position = queue.front();
+            if (position.level == depth or position.candidates.size() <= 1) continue;
+
+            /* split candidates by codes, stable - to keep indexes ascending, as filter does */
+            const size_t guess = built_nodes_[position.node].guess;
+            coded.clear();
+            for (auto&& actual : position.candidates)
+                if (feedback(guess, actual) != feedback.all_correct())
+                    coded.emplace_back(feedback(guess, actual), actual);
+            std::stable_sort(coded.begin(), coded.end(), [](auto&& lhs, auto&& rhs) { return lhs.first < rhs.first; });
+
+            built_nodes_[position.node].first_edge = static_cast<uint32_t>(built_edges_.size());
+            for (size_t first = 0, last = 0; first < coded.size(); first = last)
+            {
+                std::vector<uint32_t> bucket;
+                for (last = first; last < coded.size() and coded[last].first == coded[first].first; ++last)
+                    bucket.push_back(coded[last].second);
+
+                const auto child = static_cast<uint32_t>(built_nodes_.size());
+                const size_t selected = select(std::span<const uint32_t>{bucket}, position.level);
+                built_nodes_.push_back({static_cast<uint32_t>(selected), 0, 0});
+                built_edges_.push_back({coded[first].first, 0, child});
+                queue.push_back({child, position.level + 1, std::move(bucket)});
+            }
+            built_nodes_[position.node].children_size =
+                static_cast<uint32_t>(built_edges_.size() - built_nodes_[position.node].first_edge);
+        }
+
+        nodes_ = built_nodes_;
+        edges_ = built_edges_;
+    }
+
+    /* map file in memory, false if there is no file or it is book for other dictionary */
+    bool load(const std::string &path, uint64_t dictionary_hash, size_t depth, size_t guesses_size)
+    {
+        unmap();
+
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat info = {};
+        const bool readable = (fstat(fd, &info) == 0 and static_cast<size_t>(info.st_size) >= sizeof(Header));
+        void *mapping = readable ? mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        close(fd);
+
+        if (mapping == MAP_FAILED) return false;
+
+        mapping_ = mapping;
+        mapping_size_ = static_cast<size_t>(info.st_size);
+
+        Header header;
+        std::memcpy(&header, mapping_, sizeof(header));
+
+        const size_t expected_size = sizeof(Header) + header.nodes_size * sizeof(Node) + header.edges_size * sizeof(Edge);
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 or header.version != version or
+            header.depth != depth or header.dictionary_hash != dictionary_hash or header.nodes_size == 0 or
+            header.nodes_size > mapping_size_ or header.edges_size > mapping_size_ or expected_size != mapping_size_)
+        { unmap(); return false; }
+
+        const auto *bytes = static_cast<const char *>(mapping_);
+        nodes_ = {reinterpret_cast<const Node *>(bytes + sizeof(Header)), header.nodes_size};
+        edges_ = {reinterpret_cast<const Edge *>(bytes + sizeof(Header) + header.nodes_size * sizeof(Node)), header.edges_size};
+
+        /* do not trust file: all indexes must be valid */
+        for (auto&& node : nodes_)
+            if (node.guess >= guesses_size or size_t{node.first_edge} + node.children_size > edges_.size())
+            { unmap(); nodes_ = {}; edges_ = {}; return false; }
+        for (auto&& edge : edges_)
+            if (edge.node >= nodes_.size())
+            { unmap(); nodes_ = {}; edges_ = {}; return false; }
+
+        built_nodes_.clear();
+        built_edges_.clear();
+        return true;
+    }
+
+    /* write to temporary file and rename it, so other processes never map half of book */
+    bool save(const std::string &path, uint64_t dictionary_hash, size_t depth) const
+    {
+        Header header = {};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = version;
+        header.depth = static_cast<uint32_t>(depth);
+        header.dictionary_hash = dictionary_hash;
+        header.nodes_size = nodes_.size();
+        header.edges_size = edges_.size();
+
+        const std::string temporary = path + ".tmp." + std::to_string(getpid());
+        {
+            std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+            file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char *>(nodes_.data()), static_cast<std::streamsize>(nodes_.size_bytes()));
+            file.write(reinterpret_cast<const char *>(edges_.data()), static_cast<std::streamsize>(edges_.size_bytes()));
+            if (not file.flush())
+            { std::remove(temporary.c_str()); return false; }
+        }
+
+        return std::rename(temporary.c_str(), path.c_str()) == 0;
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------
+
+/* class DecisionCache
+    memory of guesses, which were selected in previous rounds.
+    guesses of Gamer are determined by candidates, and candidates are determined by (guess, code) pairs of round,
+    so the key is this sequence of pairs. capacity - max quantity of entries, least recently used entry is evicted.
+    is constructible by (size_t capacity)
+*/
+class DecisionCache
+{
+  public:
+    static constexpr size_t no_guess = std::numeric_limits<size_t>::max();
+
+    /* (guess, code) pairs of round */
+    using Path = std::vector<uint64_t>;
+
+    static uint64_t step(size_t guess, FeedbackTable::Code code) { return (uint64_t{guess} << 32) | code; }
+
+  private:
+    struct PathHash
+    {
+        size_t operator()(const Path &path) const
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for (auto&& step : path)
+                hash = (hash ^ step) * 1099511628211ull;
+            return static_cast<size_t>(hash);
+        }
+    };
+
+    using Entry = std::pair<Path, size_t>;
+
+    size_t capacity_;
+    /* most recently used - in front */
+    std::list<Entry> entries_;
+    std::unordered_map<Path, std::list<Entry>::iterator, PathHash> index_;
+
+  public:
+    explicit DecisionCache(size_t capacity) : capacity_(capacity)
+    { index_.reserve(capacity_); }
+
+    size_t find(const Path &path)
+    {
+        auto it = index_.find(path);
+        if (it == index_.end()) return no_guess;
+
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->second;
+    }
+
+    void insert(const Path &path, size_t guess)
+    {
+        if (capacity_ == 0) return;
+
+        if (auto it = index_.find(path); it != index_.end())
+        {
+            it->second->second = guess;
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+
+        if (entries_.size() == capacity_)
+        {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+
+        entries_.emplace_front(path, guess);
+        index_.emplace(path, entries_.begin());
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------
+
+/* class ThreadPool
+    fixed quantity of workers, which execute submitted tasks.
+    is constructible by (size_t threads)
+    have method submit(task) and method wait() - wait, while all submitted tasks will be done
+*/
+class ThreadPool
+{
+  private:
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+
+    std::mutex mutex_;
+    std::condition_variable task_ready_;
+    std::condition_variable all_done_;
+    size_t running_ = 0;
+    bool stop_ = false;
+
+    void work()
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock lock{mutex_};
+                task_ready_.wait(lock, [this] { return stop_ or not tasks_.empty(); });
+                if (stop_ and tasks_.empty()) return;
+
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+                ++running_;
+            }
+
+            task();
+
+            std::lock_guard lock{mutex_};
+            if (--running_ == 0 and tasks_.empty())
+                all_done_.notify_all();
+        }
+    }
+
+  public:
+    explicit ThreadPool(size_t threads)
+    {
+        workers_.reserve(threads);
+        for (size_t it = 0; it < threads; ++it)
+            workers_.emplace_back([this] { work(); });
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard lock{mutex_};
+            stop_ = true;
+        }
+        task_ready_.notify_all();
+        for (auto&& worker : workers_)
+            worker.join();
+    }
+
+    size_t size() const { return workers_.size(); }
+
+    void submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard lock{mutex_};
+            tasks_.push_back(std::move(task));
+        }
+        task_ready_.notify_one();
+    }
+
+    void wait()
+    {
+        std::unique_lock lock{mutex_};
+        all_done_.wait(lock, [this] { return running_ == 0 and tasks_.empty(); });
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------
+
+/* struct GamerConfig
+    settings of Gamer, which are not game parametrs
+*/
+struct GamerConfig
+{
+    /* threads for min/max, 1 - serial */
+    size_t threads = WORDLE_THREADS;
+
+    /* file of opening book (empty - no book) and quantity of guesses in book for every round */
+    std::string book_path = WORDLE_BOOK_PATH;
+    size_t book_depth = 2;
+    /* build book without file too (it is useful, when gamers share it) */
+    bool book_in_memory = false;
+
+    /* max quantity of remembered decisions of previous rounds (0 - do not remember).
+       entry is list node, map node and two copies of path: 200-250 bytes, so default capacity takes ~16 MB */
+    size_t cache_capacity = 1 << 16;
+
+    /* histograms of all guesses are maintained while there are at least incremental_threshold candidates
+       (0 - 3^L, less candidates are scanned faster, than 3^L buckets), and they take at most incremental_memory bytes
+       (0 - never maintain) */
+    size_t incremental_threshold = 0;
+    size_t incremental_memory = size_t{64} << 20;
+
+    /* lookahead_width best guesses of scoring_t are compared by worst case of candidates after two guesses
+       (and more, while there is time), search stops after lookahead_budget and returns the best found (0 - disabled) */
+    size_t lookahead_width = WORDLE_LOOKAHEAD;
+    std::chrono::milliseconds lookahead_budget{WORDLE_LOOKAHEAD_MS};
+};
+
+//------------------------------------------------------------------------------------------------------------
+
+/* scorings of guesses for BasicGamer.
+    scoring is a struct with:
+      struct Ranking - result of scoring, less is better, with index_ of guess to break ties;
+      static Ranking rank(std::span<const unsigned int> buckets, bool is_candidate, size_t index) -
+        ranking of guess by sizes of buckets of candidates, it splits candidates on (bucket "##...#" is not included,
+        is_candidate - guess itself can be answer);
+      static unsigned int bound(const Ranking &best) - guess, which has bucket greater than bound, cannot be better than best,
+        so histogram building can exit early (if rhs < lhs, than bound(rhs) <= bound(lhs));
+      static bool perfect(const Ranking &ranking) - search can be stopped on this ranking;
+      static constexpr std::string_view name - to separate opening books of different scorings.
+*/
+template <typename T>
+concept IScoring = requires(std::span<const unsigned int> buckets, bool is_candidate, size_t index, const typename T::Ranking &ranking) {
+    { T::rank(buckets, is_candidate, index) } -> std::same_as<typename T::Ranking>;
+    { T::bound(ranking) } -> std::same_as<unsigned int>;
+    { T::perfect(ranking) } -> std::same_as<bool>;
+    { ranking < ranking } -> std::same_as<bool>;
+    { ranking.index_ } -> std::convertible_to<size_t>;
+    { T::name } -> std::convertible_to<std::string_view>;
+};
+
+//------------------------------------------------------------------------------------------------------------
+
+/* min/max: minimize the worst bucket */
+struct MinMaxScoring
+{
+    static constexpr std::string_view name = "minmax";
+
+    /* range guesses */
+    struct Ranking
+    {
+        unsigned int max_score_ = std::numeric_limits<decltype(max_score_)>::max();;
+        unsigned int average_score_ = 0;
+        unsigned int best_score_ = std::numeric_limits<decltype(best_score_)>::max();
+        size_t index_ = 0;
+
+        bool operator<(const Ranking& rhs) const
+        {
+            if (max_score_ < rhs.max_score_) return true;
+            if (max_score_ > rhs.max_score_) return false;
+
+            if (average_score_ < rhs.average_score_) return true;
+            if (average_score_ > rhs.average_score_) return false;
+
+            if (best_score_ < rhs.best_score_) return true;
+            if (best_score_ > rhs.best_score_) return false;
+
+            return index_ < rhs.index_;
+        }
+    };
+
+    /* score of actual is size of its bucket */
+    static Ranking rank(std::span<const unsigned int> buckets, bool is_candidate, size_t index)
+    {
+        Ranking ranking
+        {
+            .max_score_ = 0,
+            .average_score_ = 0,
+            .best_score_ = is_candidate ? 0 : std::numeric_limits<decltype(ranking.best_score_)>::max(),
+            .index_ = index,
+        };
+
+        /* sum of squares of buckets sizes is sum of all actual scores */
+        for (auto&& bucket : buckets)
+        {
+            ranking.max_score_ = std::max(bucket, ranking.max_score_);
+            ranking.average_score_ += bucket * bucket;
+            ranking.best_score_ = std::min(bucket, ranking.best_score_);
+        }
+
+        return ranking;
+    }
+
+    static unsigned int bound(const Ranking &best) { return best.max_score_; }
+
+    static bool perfect(const Ranking &ranking) { return ranking.max_score_ == 1; }
+};
+
+//------------------------------------------------------------------------------------------------------------
+
+/* expected size of remaining candidates: sum(size^2) / candidates, candidates are the same for all guesses */
+struct ExpectedSizeScoring
+{
+    static constexpr std::string_view name = "expected-size";
+
+    struct Ranking
+    {
+        uint64_t squares_ = std::numeric_limits<decltype(squares_)>::max();
+        bool not_candidate_ = true;
+        size_t index_ = 0;
+
+        bool operator<(const Ranking &rhs) const
+        { return std::tie(squares_, not_candidate_, index_) < std::tie(rhs.squares_, rhs.not_candidate_, rhs.index_); }
+    };
+
+    static Ranking rank(std::span<const unsigned int> buckets, bool is_candidate, size_t index)
+    {
+        Ranking ranking{.squares_ = 0, .not_candidate_ = not is_candidate, .index_ = index};
+        for (auto&& bucket : buckets)
+            ranking.squares_ += uint64_t{bucket} * bucket;
+
+        return ranking;
+    }
+
+    /* bucket^2 > best sum of squares */
+    static unsigned int bound(const Ranking &best)
+    {
+        if (best.squares_ >= uint64_t{std::numeric_limits<unsigned int>::max()} * std::numeric_limits<unsigned int>::max())
+            return std::numeric_limits<unsigned int>::max();
+
+        auto root = static_cast<uint64_t>(std::sqrt(static_cast<double>(best.squares_)));
+        while (root * root > best.squares_) --root;
+        while ((root + 1) * (root + 1) <= best.squares_) ++root;
+        return static_cast<unsigned int>(root);
+    }
+
+    static bool perfect(const Ranking &) { return false; }
+};
+
+//------------------------------------------------------------------------------------------------------------
+
+/* shannon entropy of answer: log(n) - sum(size * log(size)) / n, so maximize entropy = minimize sum(size * log(size)).
+   sum is in fixed point, so equal partitions have equal rankings and ties are broken by index.
+   every bucket matters, so there is no early exit */
+struct EntropyScoring
+{
+    static constexpr std::string_view name = "entropy";
+
+    /* fixed point: 20 bits of fraction */
+    static constexpr double fixed_point_one = 1 << 20;
+
+    struct Ranking
+    {
+        uint64_t weighted_logs_ = std::numeric_limits<decltype(weighted_logs_)>::max();
+        bool not_candidate_ = true;
+        size_t index_ = 0;
+
+        bool operator<(const Ranking &rhs) const
+        {
+            return std::tie(weighted_logs_, not_candidate_, index_) <
+                   std::tie(rhs.weighted_logs_, rhs.not_candidate_, rhs.index_);
+        }
+    };
+
+    static uint64_t weighted_log(unsigned int bucket)
+    { return static_cast<uint64_t>(std::llround(bucket * std::log2(static_cast<double>(bucket)) * fixed_point_one)); }
+
+    static Ranking rank(std::span<const unsigned int> buckets, bool is_candidate, size_t index)
+    {
+        Ranking ranking{.weighted_logs_ = 0, .not_candidate_ = not is_candidate, .index_ = index};
+        for (auto&& bucket : buckets)
+            ranking.weighted_logs_ += weighted_log(bucket);
+
+        return ranking;
+    }
+
+    static unsigned int bound(const Ranking &) { return std::numeric_limits<unsigned int>::max(); }
+
+    static bool perfect(const Ranking &) { return false; }
+};
+
+//------------------------------------------------------------------------------------------------------------
+
+/* min/max first (it has early exit and guarantees worst case), than entropy for equal worst buckets */
+struct HybridScoring
+{
+    static constexpr std::string_view name = "hybrid";
+
+    struct Ranking
+    {
+        unsigned int max_score_ = std::numeric_limits<decltype(max_score_)>::max();
+        uint64_t weighted_logs_ = std::numeric_limits<decltype(weighted_logs_)>::max();
+        bool not_candidate_ = true;
+        size_t index_ = 0;
+
+        bool operator<(const Ranking &rhs) const
+        {
+            return std::tie(max_score_, weighted_logs_, not_candidate_, index_) <
+                   std::tie(rhs.max_score_, rhs.weighted_logs_, rhs.not_candidate_, rhs.index_);
+        }
+    };
+
+    static Ranking rank(std::span<const unsigned int> buckets, bool is_candidate, size_t index)
+    {
+        Ranking ranking{.max_score_ = 0, .weighted_logs_ = 0, .not_candidate_ = not is_candidate, .index_ = index};
+        for (auto&& bucket : buckets)
+        {
+            ranking.max_score_ = std::max(bucket, ranking.max_score_);
+            ranking.weighted_logs_ += EntropyScoring::weighted_log(bucket);
+        }
+
+        return ranking;
+    }
+
+    static unsigned int bound(const Ranking &best) { return best.max_score_; }
+
+    static bool perfect(const Ranking &) { return false; }
+};
+
+//------------------------------------------------------------------------------------------------------------
+
+/* class BasicGamer
+   realization of concept IGamer
+   guesses are scored by scoring_t (see IScoring) over histograms of dealer answers codes
+*/
+template <IScoring scoring_t>
+class BasicGamer
+{
+  private:
+    /* index of dictionary word */
+    static constexpr size_t no_word = std::numeric_limits<size_t>::max();
+
+  private:
+    using Ranking = typename scoring_t::Ranking;
+
+    /* memory of one worker */
+    struct Scratch
+    {
+        /* partition[code] = quantity of candidates with this code */
+        std::vector<unsigned int> partition;
+        /* not empty buckets of partition */
+        std::vector<unsigned int> buckets;
+    };
+
+    /* memory of one level of lookahead search */
+    struct LookaheadLevel
+    {
+        struct Bucket
+        {
+            unsigned int size;
+            unsigned int begin;
+            FeedbackTable::Code code;
+        };
+
+        /* offsets[code] - write position of bucket in words, zero between searches */
+        std::vector<unsigned int> offsets;
+        /* candidates grouped by codes */
+        std::vector<uint32_t> words;
+        /* not empty buckets, the largest first */
+        std::vector<Bucket> buckets;
+    };
+
+  private:
+    /* reference on game parametrs :) */
+    const GameParams &params_;
+
+    /* dealer answers for all pairs of words, calculated once per game (can be shared with other gamers) */
+    std::shared_ptr<const FeedbackTable> feedback_;
+
+    /* suitable words on every step (indexes in dictionary, all of them are less than answers_size).
+       contiguous array, because we scan it for every guess, capacity is reserved once for all rounds */
+    std::vector<uint32_t> possible_words_;
+
+    /* workers for parallel min/max (nullptr - serial mode) */
+    std::unique_ptr<ThreadPool> pool_;
+
+    /* histograms of codes for one guess, one per worker */
+    std::vector<Scratch> scratches_;
+
+    /* incremental mode: histograms_[guess * codes + code] - quantity of possible words with this code for guess.
+       they are valid, while there are at least incremental_threshold_ possible words,
+       after filtering only contribution of removed words is subtracted */
+    using Count = uint16_t;
+    std::vector<Count> histograms_;
+    std::vector<uint32_t> removed_words_;
+    bool histograms_valid_ = false;
+    bool incremental_enabled_;
+    size_t incremental_threshold_;
+
+    /* first guesses of round, if they are same in all rounds, and position of this round in book */
+    std::shared_ptr<const OpeningBook> book_;
+    size_t book_node_ = OpeningBook::no_node;
+
+    /* decisions of previous rounds and (guess, code) pairs of this round */
+    DecisionCache cache_;
+    DecisionCache::Path path_;
+
+    /* lookahead search: buffers of levels and time limit of current search */
+    size_t lookahead_width_;
+    std::chrono::milliseconds lookahead_budget_;
+    std::vector<LookaheadLevel> lookahead_levels_;
+    std::chrono::steady_clock::time_point lookahead_deadline_;
+    size_t lookahead_ticks_ = 0;
+    bool lookahead_expired_ = false;
+
+    /* save best_word_for_begin_ for all rounds */
+    size_t best_word_for_begin_ = no_word;
+    size_t last_guess_ = no_word;
+
+    /* map book from file, or build it and save for the next start */
+    void open_book(const GamerConfig &config)
+    {
+        if ((config.book_path.empty() and not config.book_in_memory) or config.book_depth == 0) return;
+
+        auto book = std::make_shared<OpeningBook>();
+        book_ = book;
+
+        const uint64_t hash = OpeningBook::dictionary_hash(params_, config.book_depth, scoring_t::name,
+                                                           config.lookahead_width, config.lookahead_budget);
+        if (not config.book_path.empty() and book->load(config.book_path, hash, config.book_depth, params_.dictionary.size()))
+            return;
+
+        /* same selection, as in live play, so book changes only time of guesses, not guesses */
+        book->build(*feedback_, params_.answers_size, config.book_depth,
+                    [this](std::span<const uint32_t> candidates, size_t guesses)
+                    { return select_guess(candidates, nullptr, params_.attempts - std::min(params_.attempts, guesses)); });
+
+        if (not config.book_path.empty() and not book->save(config.book_path, hash, config.book_depth))
+            std::cerr << "Cannot save opening book: '" << config.book_path << "'\n"; /* not fatal, only slower */
+    }
+
+    /* reset to all answers, without allocations */
+    void fill_possible_words()
+    {
+        possible_words_.resize(params_.answers_size);
+        std::iota(possible_words_.begin(), possible_words_.end(), 0);
+    }
+
+    /* compaction: keep suitable words in the same order */
+    void filter_possible_words(size_t guess, FeedbackTable::Code code)
+    {
+        WORDLE_TIMER(filter_ns);
+        const FeedbackTable::Code *row = feedback_->row(guess);
+
+        removed_words_.clear();
+        size_t kept = 0;
+        for (auto&& word : possible_words_)
+        {
+            const uint32_t current = word;
+            possible_words_[kept] = current;
+
+            const bool suitable = (row[current] == code);
+            kept += suitable;
+            if (histograms_valid_ and not suitable)
+                removed_words_.push_back(current);
+        }
+
+        WORDLE_COUNT(table_reads, possible_words_.size());
+        WORDLE_COUNT(candidates_filtered, possible_words_.size() - kept);
+        possible_words_.resize(kept);
+        update_histograms();
+    }
+
+    /* add (+1) or subtract (-1) words to histograms of all guesses */
+    void add_to_histograms(std::span<const uint32_t> words, Count sign)
+    {
+        const size_t codes_size = feedback_->codes_size();
+        for (size_t guess = 0, guesses_size = params_.dictionary.size(); guess < guesses_size; ++guess)
+        {
+            const FeedbackTable::Code *row = feedback_->row(guess);
+            Count *histogram = histograms_.data() + guess * codes_size;
+            for (auto&& word : words)
+                histogram[row[word]] = static_cast<Count>(histogram[row[word]] + sign);
+        }
+
+        WORDLE_COUNT(table_reads, params_.dictionary.size() * words.size());
+    }
+
+    void rebuild_histograms()
+    {
+        std::fill(histograms_.begin(), histograms_.end(), Count{0});
+        add_to_histograms(possible_words_, 1);
+        histograms_valid_ = true;
+    }
+
+    /* after filtering: subtract removed words, or rebuild, if there were removed more words, than kept */
+    void update_histograms()
+    {
+        if (not histograms_valid_) return;
+
+        if (possible_words_.size() < incremental_threshold_)
+            histograms_valid_ = false; /* direct scan is cheaper now */
+        else if (removed_words_.size() <= possible_words_.size())
+            add_to_histograms(removed_words_, static_cast<Count>(-1));
+        else
+            rebuild_histograms();
+    }
+
+    /* histograms of possible words, if incremental mode is suitable now, else nullptr */
+    const Count *maintained_histograms()
+    {
+        if (not incremental_enabled_ or possible_words_.size() < incremental_threshold_)
+            return nullptr;
+
+        if (not histograms_valid_)
+            rebuild_histograms();
+
+        return histograms_.data();
+    }
+
+    /* rank one guess by maintained histogram, same result as rank_guess over candidates */
+    bool rank_guess(const Count *histograms, size_t guess, unsigned int bound, Scratch &scratch, Ranking &ranking) const
+    {
+        const size_t codes_size = feedback_->codes_size();
+        const Count *histogram = histograms + guess * codes_size;
+
+        bool is_candidate = false;
+        scratch.buckets.clear();
+        for (size_t code = 0; code < codes_size; ++code)
+        {
+            const unsigned int bucket = histogram[code];
+            if (likely(bucket == 0)) continue;
+
+            if (unlikely(code == feedback_->all_correct()))
+            { is_candidate = true; continue; }
+
+            if (bucket > bound)
+            { WORDLE_COUNT(prunes, 1); return false; }
+            scratch.buckets.push_back(bucket);
+        }
+
+        WORDLE_COUNT(guesses_ranked, 1);
+        ranking = scoring_t::rank(scratch.buckets, is_candidate, guess);
+        return true;
+    }
+
+    /* rank one guess over candidates (or by maintained histogram, if histograms != nullptr).
+       return false (early exit), if some bucket is greater than bound - this guess is worse than already found */
+    bool rank_guess(std::span<const uint32_t> candidates, const Count *histograms, size_t guess, unsigned int bound,
+                    Scratch &scratch, Ranking &ranking) const
+    {
+        if (histograms != nullptr)
+            return rank_guess(histograms, guess, bound, scratch, ranking);
+
+        const FeedbackTable::Code all_correct = feedback_->all_correct();
+        const FeedbackTable::Code *row = feedback_->row(guess);
+
+        bool early_exit = false;
+        bool is_candidate = false;
+
+        /* build histogram */
+        for (auto&& actual : candidates)
+        {
+            const FeedbackTable::Code code = row[actual];
+
+            if (unlikely(code == all_correct))
+            { is_candidate = true; continue; }
+
+            if (++scratch.partition[code] <= bound) continue;
+
+            early_exit = true;
+            break;
+        }
+
+        /* collect buckets and clean histogram */
+        scratch.buckets.clear();
+        for (auto&& actual : candidates)
+        {
+            auto &bucket = scratch.partition[row[actual]];
+            if (bucket == 0) continue;
+
+            scratch.buckets.push_back(bucket);
+            bucket = 0;
+        }
+
+        WORDLE_COUNT(table_reads, candidates.size());
+        if (early_exit)
+        { WORDLE_COUNT(prunes, 1); return false; }
+
+        WORDLE_COUNT(guesses_ranked, 1);
+        ranking = scoring_t::rank(scratch.buckets, is_candidate, guess);
+        return true;
+    }
+
+    /* best guess by scoring_t, histograms - maintained histograms of candidates or nullptr */
+    size_t select_best_guess(std::span<const uint32_t> candidates, const Count *histograms = nullptr)
+    {
+        /* if remaines 1 word -> return it*/
+        if (unlikely(candidates.size() == 1))
+            return candidates.front();
+
+        if (pool_ != nullptr)
+            return select_best_guess_parallel(candidates, histograms);
+
+        Ranking best_ranking;
+
+        /* iterate by guesses */
+        for (size_t it = 0, ite = params_.dictionary.size(); it < ite; ++it)
+        {
+            Ranking ranking;
+            if (not rank_guess(candidates, histograms, it, scoring_t::bound(best_ranking), scratches_[0], ranking)) continue;
+
+            /* compare with best */
+            if (ranking < best_ranking)
+                best_ranking = ranking;
+
+            if (scoring_t::perfect(best_ranking)) break;
+        }
+
+        return best_ranking.index_;
+    }
+
+    /* same result as serial version:
+       guesses are splitted by blocks between workers, worker, which finished own blocks, steals blocks of others.
+       bound for early exit is shared between workers, so it prune guesses as in serial version.
+       serial version stops on first perfect guess, so we find minimal index of such guess,
+       else the best ranking over all guesses (ties are broken by index) */
+    size_t select_best_guess_parallel(std::span<const uint32_t> candidates, const Count *histograms)
+    {
+        static constexpr size_t block_size = 64;
+
+        /* blocks [next, end) of worker */
+        struct alignas(64) BlocksRange
+        {
+            std::atomic<size_t> next{0};
+            size_t end = 0;
+        };
+
+        const size_t guesses_size = params_.dictionary.size();
+        const size_t blocks_size = (guesses_size + block_size - 1) / block_size;
+        const size_t workers_size = pool_->size();
+
+        std::vector<BlocksRange> ranges(workers_size);
+        for (size_t worker = 0; worker < workers_size; ++worker)
+        {
+            ranges[worker].next = blocks_size * worker / workers_size;
+            ranges[worker].end = blocks_size * (worker + 1) / workers_size;
+        }
+
+        std::atomic<unsigned int> shared_bound{scoring_t::bound(Ranking{})};
+        std::atomic<size_t> first_perfect{no_word};
+        std::vector<Ranking> best_rankings(workers_size);
+
+        for (size_t worker = 0; worker < workers_size; ++worker)
+        {
+            pool_->submit([&, worker]
+            {
+                Ranking &best_ranking = best_rankings[worker];
+                Scratch &scratch = scratches_[worker];
+
+                auto&& process_block = [&](size_t block)
+                {
+                    for (size_t it = block * block_size, ite = std::min(guesses_size, it + block_size); it < ite; ++it)
+                    {
+                        if (it > first_perfect.load(std::memory_order_relaxed)) return;
+
+                        Ranking ranking;
+                        const unsigned int bound = shared_bound.load(std::memory_order_relaxed);
+                        if (not rank_guess(candidates, histograms, it, bound, scratch, ranking))
+                            continue;
+
+                        if (ranking < best_ranking)
+                            best_ranking = ranking;
+
+                        /* atomic min of bound */
+                        const unsigned int ranking_bound = scoring_t::bound(ranking);
+                        unsigned int shared = shared_bound.load(std::memory_order_relaxed);
+                        while (ranking_bound < shared and
+                               not shared_bound.compare_exchange_weak(shared, ranking_bound, std::memory_order_relaxed))
+                        {}
+
+                        if (not scoring_t::perfect(ranking)) continue;
+
+                        /* atomic min of perfect guess index */
+                        size_t perfect = first_perfect.load(std::memory_order_relaxed);
+                        while (it < perfect and
+                               not first_perfect.compare_exchange_weak(perfect, it, std::memory_order_relaxed))
+                        {}
+                        return;
+                    }
+                };
+
+                /* own blocks, than steal blocks of others */
+                for (size_t victim = 0; victim < workers_size; ++victim)
+                {
+                    BlocksRange &range = ranges[(worker + victim) % workers_size];
+                    for (size_t block = range.next++; block < range.end; block = range.next++)
+                        process_block(block);
+                }
+            });
+        }
+
+        pool_->wait();
+
+        if (first_perfect != no_word)
+            return first_perfect;
+
+        return std::min_element(best_rankings.begin(), best_rankings.end())->index_;
+    }
+
+    /* the best width guesses by scoring_t, the best first.
+       bound of the worst of them prunes other guesses as in select_best_guess */
+    std::vector<Ranking> select_top_guesses(std::span<const uint32_t> candidates, const Count *histograms, size_t width)
+    {
+        std::vector<Ranking> top; /* max-heap */
+        top.reserve(width + 1);
+
+        for (size_t it = 0, ite = params_.dictionary.size(); it < ite; ++it)
+        {
+            const unsigned int bound = scoring_t::bound(top.size() < width ? Ranking{} : top.front());
+
+            Ranking ranking;
+            if (not rank_guess(candidates, histograms, it, bound, scratches_[0], ranking)) continue;
+            if (top.size() == width and not (ranking < top.front())) continue;
+
+            top.push_back(ranking);
+            std::push_heap(top.begin(), top.end());
+            if (top.size() <= width) continue;
+
+            std::pop_heap(top.begin(), top.end());
+            top.pop_back();
+        }
+
+        std::sort_heap(top.begin(), top.end());
+        return top;
+    }
+
+    /* clock is read once per 256 calls */
+    bool lookahead_expired()
+    {
+        if (lookahead_expired_ or (++lookahead_ticks_ & 255) != 0)
+            return lookahead_expired_;
+
+        lookahead_expired_ = (std::chrono::steady_clock::now() >= lookahead_deadline_);
+        return lookahead_expired_;
+    }
+
+    /* size of the largest bucket of guess over candidates (guessed word is not counted),
+       or value greater than bound (early exit) */
+    unsigned int worst_bucket(std::span<const uint32_t> candidates, size_t guess, unsigned int bound, Scratch &scratch) const
+    {
+        const FeedbackTable::Code all_correct = feedback_->all_correct();
+        const FeedbackTable::Code *row = feedback_->row(guess);
+
+        unsigned int worst = 0;
+        for (auto&& actual : candidates)
+        {
+            const FeedbackTable::Code code = row[actual];
+            if (unlikely(code == all_correct)) continue;
+
+            worst = std::max(worst, ++scratch.partition[code]);
+            if (worst > bound)
+            { WORDLE_COUNT(prunes, 1); break; }
+        }
+
+        WORDLE_COUNT(table_reads, candidates.size());
+
+        for (auto&& actual : candidates)
+            scratch.partition[row[actual]] = 0;
+
+        return worst;
+    }
+
+    /* min by guesses of worst case quantity of candidates after depth guesses (0 - all are guessed).
+       search stops on value <= enough, caller does not need better */
+    unsigned int lookahead_best(std::span<const uint32_t> candidates, size_t depth, unsigned int enough, size_t level)
+    {
+        if (candidates.size() <= 1) return 0;
+
+        /* one guess cannot split 2 and more candidates to nothing */
+        const unsigned int lower = std::max(enough, depth == 1 ? 1u : 0u);
+        unsigned int best = candidates.size();
+
+        for (size_t it = 0, ite = params_.dictionary.size(); it < ite and best > lower; ++it)
+        {
+            if (lookahead_expired()) break;
+
+            const unsigned int value = (depth == 1) ? worst_bucket(candidates, it, best - 1, scratches_[0])
+                                                    : lookahead_worst(candidates, it, depth, best, level);
+            best = std::min(best, value);
+        }
+
+        return best;
+    }
+
+    /* max by codes of guess of lookahead_best with depth - 1 guesses left.
+       value >= alpha means, that guess is not better, than already found (branch and bound) */
+    unsigned int lookahead_worst(std::span<const uint32_t> candidates, size_t guess, size_t depth, unsigned int alpha,
+                                 size_t level)
+    {
+        const FeedbackTable::Code all_correct = feedback_->all_correct();
+        const FeedbackTable::Code *row = feedback_->row(guess);
+        LookaheadLevel &memory = lookahead_levels_[level];
+
+        /* group candidates by codes */
+        memory.buckets.clear();
+        for (auto&& actual : candidates)
+            if (memory.offsets[row[actual]]++ == 0)
+                memory.buckets.push_back({0, 0, row[actual]});
+
+        for (auto&& bucket : memory.buckets)
+            bucket.size = memory.offsets[bucket.code];
+
+        std::sort(memory.buckets.begin(), memory.buckets.end(),
+                  [](const auto &lhs, const auto &rhs) { return std::tie(rhs.size, lhs.code) < std::tie(lhs.size, rhs.code); });
+
+        unsigned int begin = 0;
+        for (auto&& bucket : memory.buckets)
+        {
+            bucket.begin = begin;
+            memory.offsets[bucket.code] = begin;
+            begin += bucket.size;
+        }
+
+        WORDLE_COUNT(table_reads, candidates.size());
+        memory.words.resize(candidates.size());
+        for (auto&& actual : candidates)
+            memory.words[memory.offsets[row[actual]]++] = actual;
+
+        for (auto&& bucket : memory.buckets)
+            memory.offsets[bucket.code] = 0;
+
+        /* the largest buckets first: they raise worst case faster */
+        unsigned int worst = 0;
+        for (auto&& bucket : memory.buckets)
+        {
+            if (bucket.size <= worst) break; /* value of bucket is not greater than its size */
+            if (bucket.code == all_correct) continue;
+
+            const std::span<const uint32_t> words(memory.words.data() + bucket.begin, bucket.size);
+            worst = std::max(worst, lookahead_best(words, depth - 1, worst, level + 1));
+
+            if (worst >= alpha)
+            { WORDLE_COUNT(prunes, 1); break; }
+            if (lookahead_expired_) break;
+        }
+
+        return worst;
+    }
+
+    /* attempts of round, which are not used yet */
+    size_t attempts_left() const { return params_.attempts - std::min(params_.attempts, path_.size()); }
+
+    /* best guess by scoring_t, refined by lookahead: iterative deepening over lookahead_width_ best guesses.
+       lines are ordered by value of previous depth, so the best of unfinished depth is compared with previous best */
+    size_t select_guess(std::span<const uint32_t> candidates, const Count *histograms, size_t attempts_left)
+    {
+        WORDLE_TIMER(select_ns);
+        if (lookahead_width_ == 0 or candidates.size() <= 2 or attempts_left < 2)
+            return select_best_guess(candidates, histograms);
+
+        lookahead_deadline_ = std::chrono::steady_clock::now() + lookahead_budget_;
+        lookahead_expired_ = false;
+        lookahead_ticks_ = 0;
+
+        struct Line
+        {
+            size_t guess;
+            unsigned int value;
+        };
+
+        std::vector<Line> lines;
+        for (auto&& ranking : select_top_guesses(candidates, histograms, lookahead_width_))
+            lines.push_back({ranking.index_, 0});
+
+        if (lookahead_levels_.size() < attempts_left)
+            lookahead_levels_.resize(attempts_left, LookaheadLevel{std::vector<unsigned int>(feedback_->codes_size(), 0), {}, {}});
+
+        size_t best = lines.front().guess;
+        for (size_t depth = 2; depth <= attempts_left; ++depth)
+        {
+            unsigned int alpha = std::numeric_limits<unsigned int>::max();
+            size_t depth_best = no_word;
+
+            for (auto&& line : lines)
+            {
+                const unsigned int value = lookahead_worst(candidates, line.guess, depth, alpha, 0);
+                if (lookahead_expired_) break;
+
+                line.value = value;
+                if (value >= alpha) continue;
+
+                alpha = value;
+                depth_best = line.guess;
+            }
+
+            if (depth_best != no_word)
+                best = depth_best;
+
+            if (lookahead_expired_ or alpha == 0) break;
+
+            std::stable_sort(lines.begin(), lines.end(), [](const Line &lhs, const Line &rhs) { return lhs.value < rhs.value; });
+        }
+
+        return best;
+    }
+
+    /* first guess is the same for all rounds, so select it over all answers only once */
+    size_t get_first_guess()
+    {
+        if (unlikely(params_.answers_size == 0))
+            throw std::runtime_error("Given no words.");
+
+        const bool first_call = (best_word_for_begin_ == no_word);
+#       define лолкек 666
+        if (likely(not first_call))
+            return best_word_for_begin_;
+
+        best_word_for_begin_ = book_->empty() ? select_guess(possible_words_, maintained_histograms(), attempts_left())
+                                             : book_->guess(book_->root());
+        return best_word_for_begin_;
+    }
+
+  public:
+    /* read-only state, which can be shared by gamers of the same dictionary and config */
+    struct Tables
+    {
+        std::shared_ptr<const FeedbackTable> feedback;
+        std::shared_ptr<const OpeningBook> book; /* nullptr - open by config */
+    };
+
+    explicit BasicGamer(const GameParams &params, const GamerConfig &config = {})
+        : BasicGamer(params, Tables{std::make_shared<const FeedbackTable>(params), nullptr}, config)
+    {}
+
+    /* gamer over tables of other gamer (see tables()), so only candidates and scratches are own */
+    explicit BasicGamer(const GameParams &params, Tables tables, const GamerConfig &config = {})
+        : params_(params), feedback_(std::move(tables.feedback)),
+          pool_(config.threads > 1 ? std::make_unique<ThreadPool>(config.threads) : nullptr),
+          scratches_(std::max<size_t>(config.threads, 1), Scratch{std::vector<unsigned int>(feedback_->codes_size(), 0), {}}),
+          book_(tables.book != nullptr ? tables.book : std::make_shared<const OpeningBook>()),
+          cache_(config.cache_capacity),
+          lookahead_width_(config.lookahead_width), lookahead_budget_(config.lookahead_budget)
+    {
+        if (unlikely(params_.answers_size > std::numeric_limits<uint32_t>::max()))
+            throw std::runtime_error("Too many answers: " + std::to_string(params_.answers_size));
+
+        incremental_threshold_ = config.incremental_threshold != 0 ? config.incremental_threshold : feedback_->codes_size();
+        const size_t histograms_size = params_.dictionary.size() * feedback_->codes_size();
+        incremental_enabled_ = histograms_size * sizeof(Count) <= config.incremental_memory and
+                               params_.answers_size <= std::numeric_limits<Count>::max();
+        if (incremental_enabled_)
+        {
+            histograms_.resize(histograms_size);
+            removed_words_.reserve(params_.answers_size);
+        }
+
+        possible_words_.reserve(params_.answers_size);
+        path_.reserve(params_.attempts);
+        fill_possible_words();
+        if (tables.book == nullptr)
+            open_book(config);
+    }
+
+    Tables tables() const { return {feedback_, book_}; }
+
+    /* IGamer interface function */
+    std::string_view try_guess_word()
+    {
+        WORDLE_TIMER(guess_ns);
+        if (unlikely(last_guess_ == no_word)) /* first attempt */
+        {
+            last_guess_ = get_first_guess();
+            book_node_ = book_->root();
+        }
+        else if (book_node_ != OpeningBook::no_node)
+            last_guess_ = book_->guess(book_node_); /* scoring was done before */
+        else if (size_t cached = cache_.find(path_); cached != DecisionCache::no_guess)
+            last_guess_ = cached; /* same position was in one of previous rounds */
+        else
+        {
+            /* select best word from point of view of scoring_t */
+            last_guess_ = select_guess(possible_words_, maintained_histograms(), attempts_left());
+            cache_.insert(path_, last_guess_);
+        }
+
+        return params_.dictionary[last_guess_];
+    }
+
+    /* IGamer interface function */
+    void become_answer(std::string_view answer)
+    {
+        const FeedbackTable::Code code = feedback_->encode(answer);
+        /* filter words by last attempt result */
+        filter_possible_words(last_guess_, code);
+        book_node_ = book_->child(book_node_, code);
+        path_.push_back(DecisionCache::step(last_guess_, code));
+    }
+
+    /* IGamer interface function */
     void ready_for_next_round()
     {
-        last_guess_.clear();
-        possible_words_.clear();
+        last_guess_ = no_word;
+        book_node_ = OpeningBook::no_node;
+        path_.clear();
+        histograms_valid_ = false;
+        fill_possible_words();
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------
+
+/* gamers with different tradeoffs of speed and quality */
+using Gamer = BasicGamer<MinMaxScoring>;
+using ExpectedSizeGamer = BasicGamer<ExpectedSizeScoring>;
+using EntropyGamer = BasicGamer<EntropyScoring>;
+using HybridGamer = BasicGamer<HybridScoring>;
+
+//------------------------------------------------------------------------------------------------------------
+
+static_assert(IGamer<Gamer>, "class Gamer must realized IGamer interface.");
+static_assert(IGamer<ExpectedSizeGamer>, "class ExpectedSizeGamer must realized IGamer interface.");
+static_assert(IGamer<EntropyGamer>, "class EntropyGamer must realized IGamer interface.");
+static_assert(IGamer<HybridGamer>, "class HybridGamer must realized IGamer interface.");
+
+//------------------------------------------------------------------------------------------------------------
+
+/*
+class Game - is constructible by (dealer_t&(&)), dealer_t - realization of IDealer (Dealer by default)
+realize wordle game with some gamer (strategy)
+have template method 'void play()',
+that play game with gamer, which type is method template type.
+template type must realize concept IGamer.
+so, to check new gamer, you need call game.play<NewGamerClarr>();
+ну красиво же спроектировал, а?
+*/
+
+template <IDealer dealer_t = Dealer>
+class Game : private dealer_t
+/* i want to use Dealer::operator<< for game, so i need private inheritance*/
+{
+  private:
+    using dealer_t::operator<<;
+    using dealer_t::operator>>;
+
+  private:
+    const GameParams params_;
+    const std::string correct_answer_;
+
+    std::string /* dealer_answer */ process_gamer_guess(std::string_view request)
+    {
+        WORDLE_TIMER(io_wait_ns);
+        /* using dealer_t::operator<< */
+        *this << request << '\n';
+        /* flush, because we need to send request, to become answer immediately */
+        dealer_t::flush();
+        /* using dealer_t::operator>> */
+        return read<std::string>(static_cast<dealer_t &>(*this));
+    }
+
+    /* check, is gamer guess correct answer */
+    bool gamer_win(std::string_view dealer_answer)
+    { return (dealer_answer == correct_answer_); }
+
+  public:
+    explicit Game(dealer_t &dealer)
+        : dealer_t(dealer),
+          params_(static_cast<dealer_t &>(*this)),
+          correct_answer_(params_.words_size, '#')
+    {
+    }
+
+    explicit Game(dealer_t &&dealer)
+        : dealer_t(std::move(dealer)),
+          params_(static_cast<dealer_t &>(*this)), /* not 'dealer', because it was destroy in move-ctor */
+          correct_answer_(params_.words_size, '#')
+    {
+    }
+
+    enum GameStatus : bool
+    {
+        WIN = true,
+        LOSE = false
+    };
+
+    template <IGamer gamer_t> GameStatus play()
+    {
+        if (unlikely(params_.attempts == 0))
+            return GameStatus::LOSE; /* no chance 😈 */
+
+        if (unlikely(params_.rounds == 0))
+            return GameStatus::WIN; /* :) */
+
+#if defined(WORDLE_STATS)
+        const Stats::Snapshot game_begin = Stats::snapshot();
+        size_t game_attempts = 0;
+#endif /* defined(WORDLE_STATS) */
+
+        /* in this game all rounds have same rules, so we dont need create gamer at every round */
+        gamer_t gamer = [this]
+        {
+            WORDLE_TIMER(startup_ns);
+            return gamer_t{params_};
+        }();
+
+        /* iterations by rounds */
+        for (size_t round = 0; round < params_.rounds; ++round)
+        {
+#if defined(WORDLE_STATS)
+            const Stats::Snapshot round_begin = Stats::snapshot();
+#endif /* defined(WORDLE_STATS) */
+            /* giving gamer 'attempts_' attempts to guess word */
+            size_t attempt = 0;
+            for (; attempt < params_.attempts; ++attempt)
+            {
+                /* get gamer request */
+                std::string_view gamer_request = gamer.try_guess_word();
+                /* become dealer answer on dealer request */
+                std::string answer = process_gamer_guess(gamer_request);
+                /* check, did gamer win. if win ->  go to the next round. else -> get gamer dealer answer */
+                if (gamer_win(answer)) break;
+                gamer.become_answer(answer);
+            }
+            /* made gamer ready to play next round */
+            gamer.ready_for_next_round();
+#if defined(WORDLE_STATS)
+            const size_t attempts = std::min(attempt + 1, params_.attempts);
+            game_attempts += attempts;
+            Stats::dump("round", {{"round", round}, {"attempts", attempts}, {"win", attempt != params_.attempts}},
+                        round_begin);
+            if (attempt == params_.attempts or round + 1 == params_.rounds)
+                Stats::dump("game", {{"rounds", round + 1}, {"attempts", game_attempts}, {"win", attempt != params_.attempts}},
+                            game_begin);
+#endif /* defined(WORDLE_STATS) */
+            /* if gamer guess the words in the less, than 'attempts_' attempts, we are going in the next round, else -
+             * gamer losed */
+            if (attempt != params_.attempts) continue;
+            return GameStatus::LOSE;
+        }
+        /* gamer guess all words, so, gamer win */
+        return GameStatus::WIN;
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------
+
+#if defined(WORDLE_BENCHMARK)
+
+/* offline benchmark of gamers: build with -DWORDLE_BENCHMARK=1 and run
+    A [words in dictionary = 2000] [words size = 5] [rounds = 0 - all answers] [seed = 1]
+    every gamer plays rounds against SimulatedJudge, report is printed to stdout.
+    before it Gamer with lookahead is checked to play the same opening with book and without it
+*/
+
+/* random dictionary: letters have frequencies of english text, words are unique, order is random */
+std::vector<std::string> generate_dictionary(size_t words, size_t words_size, uint64_t seed)
+{
+    static constexpr std::array<double, 26> english_frequencies =
+    {
+        8.2, 1.5, 2.8, 4.3, 12.7, 2.2, 2.0, 6.1, 7.0, 0.15, 0.77, 4.0, 2.4,
+        6.7, 7.5, 1.9, 0.095, 6.0, 6.3, 9.1, 2.8, 0.98, 2.4, 0.15, 2.0, 0.074,
+    };
+
+    /* 26^4 = 456976, so even 4-letters dictionary of 20'000 words can be generated */
+    if (unlikely(words_size == 0 or words > std::pow(26.0, static_cast<double>(words_size)) / 2))
+        throw std::runtime_error("Too many words of size " + std::to_string(words_size));
+
+    std::mt19937_64 random{seed};
+    std::discrete_distribution<int> letter{english_frequencies.begin(), english_frequencies.end()};
+
+    std::vector<std::string> dictionary;
+    std::unordered_set<std::string> used;
+    dictionary.reserve(words);
+
+    while (dictionary.size() < words)
+    {
+        std::string word(words_size, 'a');
+        for (auto&& c : word)
+            c = static_cast<char>('a' + letter(random));
+
+        if (used.insert(word).second)
+            dictionary.push_back(std::move(word));
+    }
+
+    return dictionary;
+}
+
+//------------------------------------------------------------------------------------------------------------
+
+/* class SimulatedJudge
+    in-process dealer: same protocol, as interactive judge has, over std::streambuf's,
+    so Game is played without any changes with Dealer{judge.requests(), judge.answers()}.
+    every game gets header with remaining secrets, after lose next game starts from next secret.
+    time of move - from answer of judge to next guess of gamer, first move of game (with gamer construction)
+    is startup time.
+*/
+class SimulatedJudge
+{
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    /* gamer writes guesses here, flush - judge answers */
+    class Requests : public std::streambuf
+    {
+      private:
+        SimulatedJudge &judge_;
+        std::string line_;
+
+      protected:
+        int_type overflow(int_type c) override
+        {
+            if (not traits_type::eq_int_type(c, traits_type::eof()))
+                line_.push_back(traits_type::to_char_type(c));
+            return traits_type::not_eof(c);
+        }
+
+        int sync() override
+        {
+            std::string_view guess = line_;
+            while (not guess.empty() and std::isspace(static_cast<unsigned char>(guess.back())))
+                guess.remove_suffix(1);
+
+            if (not guess.empty())
+                judge_.process_guess(guess);
+
+            line_.clear();
+            return 0;
+        }
+
+      public:
+        explicit Requests(SimulatedJudge &judge) : judge_(judge) {}
+    };
+
+    /* gamer reads header and answers here */
+    class Answers : public std::streambuf
+    {
+      private:
+        std::string buffer_;
+
+      public:
+        void push(std::string_view text)
+        {
+            buffer_.erase(0, static_cast<size_t>(gptr() - eback()));
+            buffer_.append(text);
+            setg(buffer_.data(), buffer_.data(), buffer_.data() + buffer_.size());
+        }
+    };
+
+  private:
+    static constexpr size_t attempts = 6;
+
+    const std::vector<std::string> &dictionary_;
+    const size_t words_size_;
+    const std::vector<size_t> &secrets_;
+    std::unordered_set<std::string_view> words_;
+
+    Requests requests_buffer_{*this};
+    Answers answers_buffer_;
+    std::ostream requests_{&requests_buffer_};
+    std::istream answers_{&answers_buffer_};
+
+    size_t secret_ = 0;  /* index in secrets_ */
+    size_t guesses_ = 0; /* guesses for current secret */
+    bool first_move_ = true;
+    Clock::time_point last_answer_;
+    Clock::time_point started_;
+
+  public:
+    struct Report
+    {
+        size_t rounds = 0;
+        size_t failures = 0;
+        size_t guesses = 0;     /* of won rounds */
+        size_t max_guesses = 0; /* of won rounds */
+        size_t games = 0;
+        double startup_seconds = 0;
+        double total_seconds = 0;
+        std::vector<double> moves_microseconds;
+    };
+
+  private:
+    Report report_;
+
+  public:
+    /* reference rules, independent from FeedbackTable */
+    std::string evaluate(std::string_view guess, std::string actual) const
+    {
+        std::string answer(words_size_, '-');
+        for (size_t i = 0; i < words_size_; ++i)
+        {
+            if (guess[i] != actual[i]) continue;
+            answer[i] = '#';
+            actual[i] = 0;
+        }
+
+        for (size_t i = 0; i < words_size_; ++i)
+        {
+            if (answer[i] == '#') continue;
+            const size_t j = actual.find(guess[i]);
+            if (j == std::string::npos) continue;
+            answer[i] = '?';
+            actual[j] = 0;
+        }
+
+        return answer;
+    }
+
+  private:
+    void process_guess(std::string_view guess)
+    {
+        const auto now = Clock::now();
+        const double microseconds = std::chrono::duration<double, std::micro>(now - last_answer_).count();
+        if (first_move_)
+            report_.startup_seconds += microseconds / 1e6;
+        else
+            report_.moves_microseconds.push_back(microseconds);
+        first_move_ = false;
+
+        if (unlikely(finished()))
+            throw std::runtime_error("Guess after end of game: '" + std::string(guess) + "'");
+        if (unlikely(not words_.contains(guess)))
+            throw std::runtime_error("Guess is not in dictionary: '" + std::string(guess) + "'");
+
+        ++guesses_;
+        const std::string answer = evaluate(guess, dictionary_[secrets_[secret_]]);
+
+        if (answer == std::string(words_size_, '#'))
+        {
+            report_.guesses += guesses_;
+            report_.max_guesses = std::max(report_.max_guesses, guesses_);
+            next_secret();
+        }
+        else if (guesses_ == attempts)
+        {
+            ++report_.failures;
+            next_secret();
+        }
+
+        answers_buffer_.push(answer + "\n");
+        last_answer_ = Clock::now();
+    }
+
+    void next_secret()
+    {
+        ++secret_;
+        ++report_.rounds;
+        guesses_ = 0;
+    }
+
+  public:
+    SimulatedJudge(const std::vector<std::string> &dictionary, size_t words_size, const std::vector<size_t> &secrets)
+        : dictionary_(dictionary), words_size_(words_size), secrets_(secrets),
+          words_(dictionary.begin(), dictionary.end())
+    {}
+
+    std::ostream &requests() { return requests_; }
+    std::istream &answers() { return answers_; }
+
+    bool finished() const { return secret_ == secrets_.size(); }
+
+    /* header of game with remaining secrets */
+    void start_game()
+    {
+        std::string header = std::to_string(dictionary_.size()) + " " + std::to_string(secrets_.size() - secret_) +
+                             " " + std::to_string(words_size_) + "\n";
+        for (auto&& word : dictionary_)
+            (header += word) += "\n";
+
+        if (report_.games++ == 0)
+            started_ = Clock::now();
+
+        first_move_ = true;
+        answers_buffer_.push(header);
+        last_answer_ = Clock::now();
+    }
+
+    Report report()
+    {
+        report_.total_seconds = std::chrono::duration<double>(Clock::now() - started_).count();
+        std::sort(report_.moves_microseconds.begin(), report_.moves_microseconds.end());
+        return report_;
     }
 };
 
 //------------------------------------------------------------------------------------------------------------
 
-static_assert(IGamer<Gamer>, "class Gamer must realized IGamer interface.");
+/* play all secrets with gamer_t and print one line of report */
+template <IGamer gamer_t>
+void benchmark(std::string_view name, const std::vector<std::string> &dictionary, size_t words_size,
+               const std::vector<size_t> &secrets)
+{
+    SimulatedJudge judge{dictionary, words_size, secrets};
+    while (not judge.finished())
+    {
+        judge.start_game();
+        Dealer dealer{judge.requests(), judge.answers()};
+        Game game{dealer};
+        game.play<gamer_t>();
+    }
+
+    const SimulatedJudge::Report report = judge.report();
+    auto&& percentile = [&moves = report.moves_microseconds](double p)
+    { return moves.empty() ? 0.0 : moves[static_cast<size_t>(p * static_cast<double>(moves.size() - 1))]; };
+
+    const size_t won = report.rounds - report.failures;
+    std::printf("%-18.*s %8zu %8.3f %6zu %8zu %10.3f %12.1f %12.1f %10.3f\n",
+                static_cast<int>(name.size()), name.data(), report.rounds,
+                won ? static_cast<double>(report.guesses) / static_cast<double>(won) : 0.0, report.max_guesses,
+                report.failures, report.startup_seconds, percentile(0.5), percentile(0.99), report.total_seconds);
+    std::fflush(stdout);
+}
+
+/* gamer_t with lookahead must play the same first guesses with opening book and without it, std::runtime_error if not.
+   budget is not limited, so search does not depend on time (dictionary must be small) */
+template <IGamer gamer_t>
+void check_opening(std::string_view name, const std::vector<std::string> &dictionary, size_t words_size,
+                   const std::vector<size_t> &secrets)
+{
+    SimulatedJudge judge{dictionary, words_size, secrets};
+    judge.start_game();
+    Dealer dealer{judge.requests(), judge.answers()};
+    const GameParams params{dealer};
+
+    GamerConfig config;
+    config.book_path.clear();
+    config.lookahead_width = 4;
+    config.lookahead_budget = std::chrono::hours{1};
+    gamer_t live{params, config};
+    config.book_in_memory = true;
+    gamer_t booked{params, config};
+
+    const std::string correct(words_size, '#');
+    for (auto&& secret : secrets)
+    {
+        for (size_t attempt = 0; attempt <= config.book_depth; ++attempt)
+        {
+            const std::string guess{live.try_guess_word()};
+            if (unlikely(guess != booked.try_guess_word()))
+                throw std::runtime_error(std::string(name) + " with book plays other opening for secret '" + dictionary[secret] + "'");
+
+            const std::string answer = judge.evaluate(guess, dictionary[secret]);
+            if (answer == correct) break;
+            live.become_answer(answer);
+            booked.become_answer(answer);
+        }
+        live.ready_for_next_round();
+        booked.ready_for_next_round();
+    }
+
+    std::printf("%-18.*s same opening with and without book: %zu secrets\n", static_cast<int>(name.size()), name.data(),
+                secrets.size());
+}
 
 //------------------------------------------------------------------------------------------------------------
 
-/*
-class Game - is constructible by (Dealear&(&))
-realize wordle game with some gamer (strategy)
-have template method 'void play()',
-that play game with gamer, which type is method template type.
-template type must realize concept IGamer.
-so, to check new gamer, you need call game.play<NewGamerClarr>();
-ну красиво же спроектировал, а?
+int main(int argc, char *argv[])
+try
+{
+    auto&& argument = [argc, argv](int i, size_t fallback) { return i < argc ? std::stoull(argv[i]) : fallback; };
+
+    const size_t words = argument(1, 2000);
+    const size_t words_size = argument(2, 5);
+    const size_t rounds = argument(3, 0);
+    const uint64_t seed = argument(4, 1);
+
+    const std::vector<std::string> dictionary = generate_dictionary(words, words_size, seed);
+
+    /* answers are first 2000 words, as in game */
+    std::vector<size_t> secrets(std::min<size_t>(words, 2000));
+    std::iota(secrets.begin(), secrets.end(), 0);
+    if (rounds != 0 and rounds < secrets.size())
+    {
+        std::vector<size_t> sample;
+        std::sample(secrets.begin(), secrets.end(), std::back_inserter(sample), rounds, std::mt19937_64{seed});
+        std::shuffle(sample.begin(), sample.end(), std::mt19937_64{seed});
+        secrets = std::move(sample);
+    }
+
+    /* opening of lookahead with book, on small dictionary, so search is finished */
+    {
+        static constexpr size_t opening_words = 300;
+        const std::vector<std::string> small = generate_dictionary(opening_words, words_size, seed);
+        std::vector<size_t> all(small.size());
+        std::iota(all.begin(), all.end(), 0);
+        check_opening<Gamer>("minmax", small, words_size, all);
+    }
+
+    std::printf("dictionary: %zu words of %zu letters, rounds: %zu, seed: %llu\n", words, words_size, secrets.size(),
+                static_cast<unsigned long long>(seed));
+    std::printf("%-18s %8s %8s %6s %8s %10s %12s %12s %10s\n", "gamer", "rounds", "avg", "max", "failures",
+                "startup,s", "move p50,us", "move p99,us", "total,s");
+
+    benchmark<Gamer>("minmax", dictionary, words_size, secrets);
+    benchmark<ExpectedSizeGamer>("expected-size", dictionary, words_size, secrets);
+    benchmark<EntropyGamer>("entropy", dictionary, words_size, secrets);
+    benchmark<HybridGamer>("hybrid", dictionary, words_size, secrets);
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Benchmark error: " << e.what() << "\n";
+    return EXIT_FAILURE;
+}
+
+#elif defined(WORDLE_SERVER)
+
+/* solver server: build with -DWORDLE_SERVER=1 and run
+    A <unix socket path> [threads = cores] < dictionary
+    dictionary has judge format (words, rounds - ignored, words size, words), feedback table and opening book
+    are built once and shared by all sessions.
+    every connection is a session: client sends quantity of rounds and than plays as judge: server writes guess,
+    client answers with feedback. after the last round, lost round (server writes LOSE) or bad input
+    server closes connection
 */
 
-class Game : private Dealer
-/* i want to use Dealer::operator<< for game, so i need private inheritance*/
+/* class SolverServer
+    poll loop in main thread reads sockets of idle sessions, session with complete line becomes busy
+    and is processed by ThreadPool, worker returns it back through finished_ and wakes loop by pipe.
+    so state of session (candidates of own gamer) is used by one thread at once without locks
+*/
+class SolverServer
 {
   private:
-    using Dealer::operator<<;
-    using Dealer::operator>>;
+    using gamer_t = WORDLE_GAMER;
+
+    struct Session
+    {
+        int fd;
+        gamer_t gamer;
+        std::string input;
+        size_t rounds = 0; /* 0 - not received yet */
+        size_t round = 0;
+        size_t attempt = 0;
+        bool busy = false;
+        bool finished = false;
+
+        Session(int fd, const GameParams &params, const gamer_t::Tables &tables, const GamerConfig &config)
+            : fd(fd), gamer(params, tables, config)
+        {}
+    };
+
+    /* answer of server instead of guess, when attempts of round are over */
+    static constexpr std::string_view lost_line = "LOSE\n";
 
-  private:
     const GameParams params_;
     const std::string correct_answer_;
 
-    std::string /* dealer_answer */ process_gamer_guess(std::string_view request)
+    /* settings of sessions: no threads, caches and histograms of own - they are too big for thousands of sessions */
+    GamerConfig session_config_;
+    gamer_t::Tables tables_;
+
+    int listener_ = -1;
+    int wake_[2] = {-1, -1};
+
+    std::unordered_map<int, std::unique_ptr<Session>> sessions_;
+    std::mutex finished_mutex_;
+    std::vector<int> finished_;
+
+    /* the last member: workers are joined before sessions are destroyed */
+    ThreadPool pool_;
+
+    static void check(bool ok, std::string_view what)
     {
-        /* using Dealer::operator<< */
-        *this << request;
-        /* std::endl because we need to flush ostream buffer, to become answer immediately */
-        std::endl(static_cast<std::ostream &>(static_cast<Dealer&>(*this)));
-        /* using Dealer::operator>> */
-        return read<std::string>(*this);
+        if (unlikely(not ok))
+            throw std::runtime_error(std::string(what) + ": " + std::strerror(errno));
     }
 
-    /* check, is gamer guess correct answer */
-    bool gamer_win(std::string_view dealer_answer)
-    { return (dealer_answer == correct_answer_); }
+    static GamerConfig shared_config()
+    {
+        GamerConfig config;
+        config.book_in_memory = true;
+        return config;
+    }
 
-  public:
-    explicit Game(Dealer &dealer)
-        : Dealer(dealer),
-          params_(dealer),
-          correct_answer_(params_.words_size, '#')
+    /* all bytes or false (client is gone), MSG_NOSIGNAL - closed client must not kill server by SIGPIPE */
+    static bool send_all(int fd, std::string_view data)
     {
+        while (not data.empty())
+        {
+            const ssize_t put = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+            if (likely(put >= 0)) { data.remove_prefix(static_cast<size_t>(put)); continue; }
+            if (errno != EINTR) return false;
+        }
+        return true;
     }
 
-    explicit Game(Dealer &&dealer)
-        : Dealer(std::move(dealer)),
-          params_(static_cast<Dealer &>(*this)), /* not 'dealer', because it was destroy in move-ctor */
-          correct_answer_(params_.words_size, '#')
+    /* one line of client, false - session is over */
+    bool process_line(Session &session, std::string_view line, std::string &output)
     {
+        if (session.rounds == 0)
+        {
+            session.rounds = 0;
+            for (auto&& c : line)
+            {
+                if (unlikely(c < '0' or c > '9'))
+                    throw std::runtime_error("Expected quantity of rounds: '" + std::string(line) + "'");
+                if (unlikely(__builtin_mul_overflow(session.rounds, size_t{10}, &session.rounds) or
+                             __builtin_add_overflow(session.rounds, static_cast<size_t>(c - '0'), &session.rounds)))
+                    throw std::runtime_error("Too big quantity of rounds: '" + std::string(line) + "'");
+            }
+
+            if (session.rounds == 0) return false;
+        }
+        else if (line == correct_answer_)
+        {
+            session.gamer.ready_for_next_round();
+            session.attempt = 0;
+            if (++session.round == session.rounds) return false;
+        }
+        else
+        {
+            if (unlikely(line.size() != params_.words_size))
+                throw std::runtime_error("Invalid answer size: '" + std::string(line) + "'");
+
+            session.gamer.become_answer(line);
+            if (++session.attempt == params_.attempts)
+            {
+                output.append(lost_line); /* client knows, why connection is closed */
+                return false;
+            }
+        }
+
+        output.append(session.gamer.try_guess_word());
+        output.push_back('\n');
+        return true;
     }
 
-    enum GameStatus : bool
+    /* in worker: all complete lines of input */
+    void process(Session &session)
     {
-        WIN = true,
-        LOSE = false
-    };
+        std::string output;
+        try
+        {
+            size_t begin = 0;
+            for (size_t end; not session.finished and (end = session.input.find('\n', begin)) != std::string::npos; begin = end + 1)
+            {
+                std::string_view line{session.input.data() + begin, end - begin};
+                if (not line.empty() and line.back() == '\r')
+                    line.remove_suffix(1);
+                if (line.empty()) continue;
 
-    template <IGamer gamer_t> GameStatus play()
+                session.finished = not process_line(session, line, output);
+            }
+            session.input.erase(0, begin);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Session error: " << e.what() << "\n";
+            session.finished = true;
+        }
+
+        if (not send_all(session.fd, output))
+            session.finished = true;
+
+        {
+            std::lock_guard lock{finished_mutex_};
+            finished_.push_back(session.fd);
+        }
+
+        const char wake = 0;
+        while (::write(wake_[1], &wake, 1) < 0 and errno == EINTR)
+        {}
+    }
+
+    void close_session(int fd)
     {
-        if (unlikely(params_.attempts == 0))
-            return GameStatus::LOSE; /* no chance 😈 */
+        sessions_.erase(fd);
+        ::close(fd);
+    }
 
-        if (unlikely(params_.rounds == 0))
-            return GameStatus::WIN; /* :) */
+    void accept_session()
+    {
+        const int fd = ::accept(listener_, nullptr, nullptr);
+        if (fd < 0) return; /* client is gone before accept, or limit of descriptors: try at next poll */
 
-        /* in this game all rounds have same rules, so we dont need create gamer at every round */
-        gamer_t gamer{params_};
+        try
+        {
+            sessions_.emplace(fd, std::make_unique<Session>(fd, params_, tables_, session_config_));
+        }
+        catch (...)
+        {
+            ::close(fd);
+            throw;
+        }
+    }
 
-        /* iterations by rounds */
-        for (size_t round = 0; round < params_.rounds; ++round)
+    /* main thread: new bytes of idle session */
+    void read_session(Session &session)
+    {
+        char buffer[4096];
+        const ssize_t got = ::read(session.fd, buffer, sizeof(buffer));
+        if (got < 0 and errno == EINTR) return;
+        if (got <= 0)
         {
-            /* giving gamer 'attempts_' attempts to guess word */
-            size_t attempt = 0;
-            for (; attempt < params_.attempts; ++attempt)
+            close_session(session.fd);
+            return;
+        }
+
+        session.input.append(buffer, static_cast<size_t>(got));
+        if (session.input.find('\n') == std::string::npos) return;
+
+        session.busy = true;
+        pool_.submit([this, &session] { process(session); });
+    }
+
+    /* main thread: sessions returned by workers */
+    void collect_finished()
+    {
+        char drain[256];
+        while (::read(wake_[0], drain, sizeof(drain)) > 0)
+        {}
+
+        std::vector<int> finished;
+        {
+            std::lock_guard lock{finished_mutex_};
+            finished.swap(finished_);
+        }
+
+        for (auto&& fd : finished)
+        {
+            Session &session = *sessions_.at(fd);
+            session.busy = false;
+            if (session.finished)
+                close_session(fd);
+        }
+    }
+
+  public:
+    template <IDealer dealer_t>
+    explicit SolverServer(const std::string &path, size_t threads, dealer_t &dealer)
+        : params_(dealer), correct_answer_(params_.words_size, '#'),
+          tables_(gamer_t{params_, shared_config()}.tables()),
+          pool_(std::max<size_t>(threads, 1))
+    {
+        session_config_.threads = 1;
+        session_config_.cache_capacity = 0;
+        session_config_.incremental_memory = 0;
+
+        check(::pipe2(wake_, O_NONBLOCK | O_CLOEXEC) == 0, "Cannot create pipe");
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (unlikely(path.size() >= sizeof(address.sun_path)))
+            throw std::runtime_error("Too long socket path: '" + path + "'");
+        std::copy(path.begin(), path.end(), address.sun_path);
+
+        listener_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        check(listener_ >= 0, "Cannot create socket");
+        ::unlink(path.c_str());
+        check(::bind(listener_, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0, "Cannot bind '" + path + "'");
+        check(::listen(listener_, SOMAXCONN) == 0, "Cannot listen '" + path + "'");
+    }
+
+    SolverServer(const SolverServer &) = delete;
+    SolverServer &operator=(const SolverServer &) = delete;
+
+    ~SolverServer()
+    {
+        pool_.wait();
+        for (auto&& [fd, session] : sessions_)
+            ::close(fd);
+        for (int fd : {listener_, wake_[0], wake_[1]})
+            if (fd >= 0) ::close(fd);
+    }
+
+    /* serve forever */
+    void run()
+    {
+        std::vector<pollfd> polled;
+        std::vector<Session *> polled_sessions;
+        for (;;)
+        {
+            polled.assign({pollfd{listener_, POLLIN, 0}, pollfd{wake_[0], POLLIN, 0}});
+            polled_sessions.clear();
+            for (auto&& [fd, session] : sessions_)
             {
-                /* get gamer request */
-                std::string_view gamer_request = gamer.try_guess_word();
-                /* become dealer answer on dealer request */
-                std::string answer = process_gamer_guess(gamer_request);
-                /* check, did gamer win. if win ->  go to the next round. else -> get gamer dealer answer */
-                if (gamer_win(answer)) break;
-                gamer.become_answer(answer);
+                if (session->busy) continue;
+                polled.push_back(pollfd{fd, POLLIN, 0});
+                polled_sessions.push_back(session.get());
             }
-            /* made gamer ready to play next round */
-            gamer.ready_for_next_round();
-            /* if gamer guess the words in the less, than 'attempts_' attempts, we are going in the next round, else -
-             * gamer losed */
-            if (attempt != params_.attempts) continue;
-            return GameStatus::LOSE;
+
+            if (::poll(polled.data(), polled.size(), -1) < 0)
+            {
+                check(errno == EINTR, "Cannot poll");
+                continue;
+            }
+
+            /* sessions first: accept and collect change sessions_ */
+            for (size_t it = 0; it < polled_sessions.size(); ++it)
+                if (polled[it + 2].revents != 0)
+                    read_session(*polled_sessions[it]);
+
+            if (polled[1].revents != 0) collect_finished();
+            if (polled[0].revents != 0) accept_session();
         }
-        /* gamer guess all words, so, gamer win */
-        return GameStatus::WIN;
     }
 };
 
 //------------------------------------------------------------------------------------------------------------
 
+int main(int argc, char *argv[])
+try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <unix socket path> [threads] < dictionary\n";
+        return EXIT_FAILURE;
+    }
+
+    const size_t threads = argc > 2 ? std::stoull(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+
+    FdDealer dealer{STDOUT_FILENO, STDIN_FILENO};
+    SolverServer server{argv[1], threads, dealer};
+    server.run();
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Server error: " << e.what() << "\n";
+    return EXIT_FAILURE;
+}
+
+#else /* defined(WORDLE_BENCHMARK) or defined(WORDLE_SERVER) */
+
 /* LETS GO!!! */
 decltype(лолкек) main()
 try
 {
-    /* init game with dealer, which is std::cout + std::cin */
-    Game game{Dealer{std::cout, std::cin}};
+    /* init game with dealer, which is stdout + stdin without iostreams */
+    Game game{FdDealer{STDOUT_FILENO, STDIN_FILENO}};
     /* playing game with our gamer */
-    Game::GameStatus game_status = game.play<Gamer>();
+    decltype(game)::GameStatus game_status = game.play<WORDLE_GAMER>();
     /* parse game result_*/
-    if (unlikely(game_status == Game::LOSE)) /* we still try always win, so nothing bad in __builtin_expect :) */
+    if (unlikely(game_status == decltype(game)::LOSE)) /* we still try always win, so nothing bad in __builtin_expect :) */
         return EXIT_FAILURE; /* our gamer lose */
 
     return EXIT_SUCCESS; /* our gamer win!!! */
@@ -587,6 +2908,8 @@ catch (...)
     return EXIT_FAILURE;
 }
 
+#endif /* defined(WORDLE_BENCHMARK) or defined(WORDLE_SERVER) */
+
 //------------------------------------------------------------------------------------------------------------
 
 // Примечания
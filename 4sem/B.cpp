@@ -3,6 +3,35 @@
 #include <stdexcept>
 #define КОНЧЕЛЫГА 666
 #include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 
 #if defined(SEBELEV_MAKSIM_MAKSIMOVICH)
@@ -75,22 +104,2237 @@ concept DirectionalGraph = CommonGraph<T> && requires(const T &cg) {
 namespace Graph
 {
 
+/* struct BasicEdge
+    edge from src to dst (for PlainGraph direction is not important)
+*/
+template <typename vertex_t>
+struct BasicEdge
+{
+    using Vertex = vertex_t;
+
+    Vertex src;
+    Vertex dst;
+
+    bool operator==(const BasicEdge &) const = default;
+};
+
+/* enum Relabeling
+    order of vertices in memory (see relabel of graphs), vertices of graph are not changed
+*/
+enum Relabeling
+{
+    DEGREE,       /* by decreasing degree: rows of hubs are together */
+    CUTHILL_MCKEE /* reverse Cuthill-McKee: BFS by increasing degree, so neighbors are close */
+};
+
+namespace detail
+{
+
+/* class EdgeSet
+    open addressing hash set of edges (linear probing, load factor <= 1/2), edge {max, max} marks empty slot
+*/
+template <typename vertex_t>
+class EdgeSet
+{
+  private:
+    using Edge = BasicEdge<vertex_t>;
+
+    static constexpr vertex_t no_vertex = std::numeric_limits<vertex_t>::max();
+
+    std::vector<Edge> slots_;
+    size_t size_ = 0;
+
+    static size_t hash(const Edge &e)
+    {
+        uint64_t h = static_cast<uint64_t>(e.src) * 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(e.dst);
+        h ^= h >> 32;
+        h *= 0xD6E8FEB86659FD93ull;
+        h ^= h >> 32;
+        return static_cast<size_t>(h);
+    }
+
+    /* slot of e, or empty slot, where it must be */
+    size_t find(const Edge &e) const
+    {
+        const size_t mask = slots_.size() - 1;
+        size_t it = hash(e) & mask;
+        while (slots_[it].src != no_vertex and not (slots_[it] == e))
+            it = (it + 1) & mask;
+        return it;
+    }
+
+    void rehash(size_t capacity)
+    {
+        std::vector<Edge> slots(capacity, Edge{no_vertex, no_vertex});
+        slots_.swap(slots);
+        for (auto&& e : slots)
+            if (e.src != no_vertex)
+                slots_[find(e)] = e;
+    }
+
+  public:
+    bool contains(const Edge &e) const { return size_ != 0 and slots_[find(e)] == e; }
+
+    /* false, if e is already in set */
+    bool insert(const Edge &e)
+    {
+        if (2 * (size_ + 1) > slots_.size())
+            rehash(std::max<size_t>(16, 2 * slots_.size()));
+
+        Edge &slot = slots_[find(e)];
+        if (slot == e) return false;
+
+        slot = e;
+        ++size_;
+        return true;
+    }
+
+    void clear()
+    {
+        slots_ = {};
+        size_ = 0;
+    }
+};
+
+/* body(begin, end) for blocks [begin, end) of [0, size), begin is multiple of parallel_block.
+   blocks are taken by hardware threads dynamically, small ranges are processed serially */
+static constexpr size_t parallel_block = 1 << 14;
+
+template <typename body_t>
+void parallelFor(size_t size, body_t &&body)
+{
+    const size_t blocks = (size + parallel_block - 1) / parallel_block;
+    const size_t threads = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), blocks);
+    if (threads <= 1)
+    {
+        for (size_t begin = 0; begin < size; begin += parallel_block)
+            body(begin, std::min(size, begin + parallel_block));
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    auto&& work = [&]
+    {
+        for (size_t begin; (begin = next.fetch_add(parallel_block, std::memory_order_relaxed)) < size;)
+            body(begin, std::min(size, begin + parallel_block));
+    };
+
+    std::vector<std::jthread> workers;
+    workers.reserve(threads - 1);
+    for (size_t it = 1; it < threads; ++it)
+        workers.emplace_back(work);
+    work();
+}
+
+/* class Mapping
+    read only file in memory, std::runtime_error if it cannot be mapped.
+    it is shared by arrays, which view it, so it is unmapped with the last of them
+*/
+class Mapping
+{
+  private:
+    void *data_ = nullptr;
+    size_t size_ = 0;
+
+  public:
+    explicit Mapping(const std::string &path)
+    {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Cannot open '" + path + "' to load graph.");
+
+        struct stat info = {};
+        const bool readable = (fstat(fd, &info) == 0 and info.st_size > 0);
+        void *data = readable ? mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        close(fd);
+
+        if (data == MAP_FAILED)
+            throw std::runtime_error("Cannot map '" + path + "' to load graph.");
+
+        data_ = data;
+        size_ = static_cast<size_t>(info.st_size);
+    }
+
+    Mapping(const Mapping &) = delete;
+    Mapping &operator=(const Mapping &) = delete;
+    ~Mapping() { munmap(data_, size_); }
+
+    const char *data() const { return static_cast<const char *>(data_); }
+    size_t size() const { return size_; }
+};
+
+/* class Array
+    read only array: own vector or view of mapped file. graphs never change arrays, they replace them,
+    so loaded graph reads mapped pages till the first change
+*/
+template <typename T>
+class Array
+{
+  private:
+    std::vector<T> owned_;
+    std::shared_ptr<const Mapping> mapping_;
+    std::span<const T> view_;
+
+  public:
+    Array() = default;
+    Array(std::vector<T> owned) : owned_(std::move(owned)), view_(owned_) {}
+    Array(std::shared_ptr<const Mapping> mapping, std::span<const T> view) : mapping_(std::move(mapping)), view_(view) {}
+
+    Array(const Array &rhs) : owned_(rhs.owned_), mapping_(rhs.mapping_), view_(mapping_ ? rhs.view_ : std::span<const T>(owned_)) {}
+
+    /* buffer of moved vector is not changed, so view stays valid */
+    Array(Array &&rhs) noexcept
+      : owned_(std::move(rhs.owned_)), mapping_(std::move(rhs.mapping_)), view_(std::exchange(rhs.view_, {}))
+    {}
+
+    Array &operator=(Array rhs) noexcept
+    {
+        owned_.swap(rhs.owned_);
+        mapping_.swap(rhs.mapping_);
+        std::swap(view_, rhs.view_);
+        return *this;
+    }
+
+    operator std::span<const T>() const { return view_; }
+
+    size_t size() const { return view_.size(); }
+    const T *data() const { return view_.data(); }
+    const T &operator[](size_t index) const { return view_[index]; }
+    const T &front() const { return view_.front(); }
+    const T &back() const { return view_.back(); }
+    auto begin() const { return view_.begin(); }
+    auto end() const { return view_.end(); }
+
+    bool operator==(const Array &rhs) const { return std::ranges::equal(view_, rhs.view_); }
+};
+
+/* struct FileHeader
+    binary file of graph: FileHeader, than arrays, every one is padded to alignment:
+        offsets[vertices + 1] and neighbors[offsets[vertices]] of CSR (stored vertices have vertex_size bytes),
+        stored vertex of every vertex and vertex of every stored vertex (flags & relabeled),
+        the same for incoming arcs (flags & incoming),
+        component ids[vertices] (flags & components).
+    integers are native and arrays are the same as in memory, so file is mapped and used without parsing
+*/
+struct FileHeader
+{
+    static constexpr char magic_value[8] = {'G', 'R', 'A', 'P', 'H', 'C', 'S', 'R'};
+    static constexpr uint32_t current_version = 1;
+    static constexpr size_t alignment = 8;
+
+    /* flags */
+    static constexpr uint32_t symmetric = 1;
+    static constexpr uint32_t incoming = 2;
+    static constexpr uint32_t components = 4;
+    static constexpr uint32_t relabeled = 8;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t vertex_size;
+    uint32_t reserved; /* explicit padding, so file has no garbage bytes */
+    uint64_t vertices;
+    uint64_t edges;
+    uint64_t components_size;
+
+    static constexpr size_t padded(size_t bytes) { return (bytes + alignment - 1) / alignment * alignment; }
+};
+
+static_assert(std::is_trivially_copyable_v<FileHeader> and sizeof(FileHeader) % FileHeader::alignment == 0,
+              "header is saved as raw memory");
+static_assert(sizeof(size_t) == sizeof(uint64_t), "offsets are saved as raw memory");
+
+/* class FileWriter
+    graph is written to temporary file by large writes, commit() renames it, so other processes never map half of graph
+*/
+class FileWriter
+{
+  private:
+    std::string path_;
+    std::string temporary_;
+    std::ofstream file_;
+    bool committed_ = false;
+
+  public:
+    FileWriter(const std::string &path, uint32_t flags, uint32_t vertex_size, uint64_t vertices, uint64_t edges,
+               uint64_t components_size)
+      : path_(path), temporary_(path + ".tmp." + std::to_string(getpid())), file_(temporary_, std::ios::binary | std::ios::trunc)
+    {
+        if (not file_)
+            throw std::runtime_error("Cannot open '" + temporary_ + "' to dump graph.");
+
+        FileHeader header = {};
+        std::memcpy(header.magic, FileHeader::magic_value, sizeof(header.magic));
+        header.version = FileHeader::current_version;
+        header.flags = flags;
+        header.vertex_size = vertex_size;
+        header.vertices = vertices;
+        header.edges = edges;
+        header.components_size = components_size;
+        file_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+
+    FileWriter(const FileWriter &) = delete;
+    FileWriter &operator=(const FileWriter &) = delete;
+
+    ~FileWriter()
+    {
+        if (committed_) return;
+        file_.close();
+        std::remove(temporary_.c_str());
+    }
+
+    template <typename T>
+    void write(std::span<const T> array)
+    {
+        static constexpr char padding[FileHeader::alignment] = {};
+        file_.write(reinterpret_cast<const char *>(array.data()), static_cast<std::streamsize>(array.size_bytes()));
+        file_.write(padding, static_cast<std::streamsize>(FileHeader::padded(array.size_bytes()) - array.size_bytes()));
+    }
+
+    void commit()
+    {
+        file_.close();
+        if (not file_ or std::rename(temporary_.c_str(), path_.c_str()) != 0)
+            throw std::runtime_error("Cannot dump graph to '" + path_ + "'.");
+        committed_ = true;
+    }
+};
+
+/* class FileReader
+    mapped file of graph: header is checked, arrays are views of mapped pages, std::runtime_error for broken file
+*/
+class FileReader
+{
+  private:
+    std::string path_;
+    std::shared_ptr<const Mapping> mapping_;
+    FileHeader header_ = {};
+    size_t position_ = sizeof(FileHeader);
+
+  public:
+    explicit FileReader(const std::string &path) : path_(path), mapping_(std::make_shared<const Mapping>(path))
+    {
+        if (mapping_->size() >= sizeof(FileHeader))
+            std::memcpy(&header_, mapping_->data(), sizeof(header_));
+
+        if (std::memcmp(header_.magic, FileHeader::magic_value, sizeof(header_.magic)) != 0 or
+            header_.version != FileHeader::current_version)
+            throw std::runtime_error("'" + path_ + "' is not graph file of this version.");
+    }
+
+    const FileHeader &header() const { return header_; }
+
+    template <typename T>
+    Array<T> read(size_t size)
+    {
+        if (position_ > mapping_->size() or size > (mapping_->size() - position_) / sizeof(T))
+            throw std::runtime_error("Graph file '" + path_ + "' is truncated.");
+
+        const auto *data = reinterpret_cast<const T *>(mapping_->data() + position_);
+        position_ += FileHeader::padded(size * sizeof(T));
+        return {mapping_, {data, size}};
+    }
+};
+
+/* class Adjacency
+    compressed sparse row: neighbors of vertex v are neighbors_[offsets_[v], offsets_[v + 1]), one contiguous array,
+    every row is sorted, so arc is found by binary search (short rows - by linear scan).
+    new edges are appended to staging buffer. read merges them in CSR by one pass, if they are at least 1/merge_ratio
+    of it, so graph is built in O(V + E log(degree)), else it merges only row, which is read (see Patch),
+    so reads between addEdge cost O(degree), not O(V + E). staged edges are indexed by EdgeSet,
+    so duplicates are rejected without merge.
+    symmetric - edge u-v is stored as arcs u->v and v->u (it is staged and indexed once, as {min, max}).
+    reads are const, so CSR is mutable: const methods of graphs are not thread safe, while there are staged edges.
+    CSR arrays can be views of mapped file (see read), every change replaces them by own arrays
+*/
+template <typename vertex_t, bool symmetric>
+class Adjacency
+{
+  public:
+    using Vertex = vertex_t;
+
+  private:
+    template <typename, bool> friend class Adjacency;
+
+    using Edge = BasicEdge<vertex_t>;
+
+    /* rows up to this size are scanned linearly, it is faster than binary search */
+    static constexpr size_t small_row = 16;
+    /* staged arcs are merged in whole CSR, when they are at least 1/merge_ratio of it, so every arc is merged O(1) times */
+    static constexpr size_t merge_ratio = 4;
+
+    /* row with staged arcs, which was read before merge: staged arcs of row and merged row, it is rebuilt by read after change */
+    struct Patch
+    {
+        std::vector<vertex_t> staged;
+        std::vector<vertex_t> row;
+        bool merged = false;
+    };
+
+    size_t vertices_ = 0;
+    size_t edges_ = 0;
+
+    mutable Array<size_t> offsets_{std::vector<size_t>{0}};
+    mutable Array<vertex_t> neighbors_;
+    mutable std::vector<Edge> staged_;
+    mutable EdgeSet<vertex_t> staged_index_;
+    mutable std::unordered_map<vertex_t, Patch> patches_;
+    /* prefix of staged_, which is distributed to patches_ */
+    mutable size_t patched_ = 0;
+
+    static Edge key(vertex_t src, vertex_t dst)
+    {
+        if constexpr (symmetric)
+            return {std::min(src, dst), std::max(src, dst)};
+        else
+            return {src, dst};
+    }
+
+    /* row in CSR, without staged edges (vertex added after merge has empty row) */
+    std::span<const vertex_t> compactedRow(vertex_t v) const
+    {
+        if (v + 1 >= offsets_.size()) return {};
+        return {neighbors_.data() + offsets_[v], offsets_[v + 1] - offsets_[v]};
+    }
+
+    /* arc in CSR, without merge of staged edges */
+    bool compactedHas(vertex_t src, vertex_t dst) const
+    {
+        const std::span<const vertex_t> row = compactedRow(src);
+        const vertex_t *first = row.data();
+        size_t size = row.size();
+        if (size == 0) return false;
+        if (size <= small_row)
+            return std::find(first, first + size, dst) != first + size;
+
+        /* branchless: first - the last element <= dst */
+        while (size > 1)
+        {
+            const size_t half = size / 2;
+            first = (first[half] <= dst) ? first + half : first;
+            size -= half;
+        }
+        return *first == dst;
+    }
+
+    void dropStaged() const
+    {
+        staged_.clear();
+        staged_.shrink_to_fit();
+        staged_index_.clear();
+        patches_.clear();
+        patched_ = 0;
+    }
+
+    /* merged row of v, if it has staged arcs: new staged arcs are distributed to rows, than row of v is merged once */
+    const Patch *patch(vertex_t v) const
+    {
+        for (; patched_ < staged_.size(); ++patched_)
+        {
+            const Edge &e = staged_[patched_];
+            Patch &src = patches_[e.src];
+            src.staged.push_back(e.dst);
+            src.merged = false;
+            if constexpr (symmetric)
+            {
+                Patch &dst = patches_[e.dst];
+                dst.staged.push_back(e.src);
+                dst.merged = false;
+            }
+        }
+
+        const auto found = patches_.find(v);
+        if (found == patches_.end()) return nullptr;
+
+        Patch &patch = found->second;
+        if (not patch.merged)
+        {
+            const std::span<const vertex_t> row = compactedRow(v);
+            std::sort(patch.staged.begin(), patch.staged.end());
+            patch.row.resize(row.size() + patch.staged.size());
+            std::merge(row.begin(), row.end(), patch.staged.begin(), patch.staged.end(), patch.row.begin());
+            patch.merged = true;
+        }
+        return &patch;
+    }
+
+  public:
+    Adjacency() = default;
+
+    /* copy with other type of vertices, vertex v is renamed to labels[v] (labels.empty() - it is not renamed).
+       rows are copied and sorted in parallel */
+    template <typename other_t>
+    Adjacency(const Adjacency<other_t, symmetric> &rhs, std::span<const uint64_t> labels)
+      : vertices_(rhs.vertices_), edges_(rhs.edges_)
+    {
+        rhs.compact();
+        auto&& label = [&](uint64_t v) { return labels.empty() ? v : labels[v]; };
+
+        std::vector<size_t> offsets(vertices_ + 1, 0);
+        for (size_t v = 0; v < vertices_; ++v)
+            offsets[label(v) + 1] = rhs.offsets_[v + 1] - rhs.offsets_[v];
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        std::vector<vertex_t> neighbors(offsets.back());
+        parallelFor(vertices_, [&](size_t begin, size_t end)
+        {
+            for (size_t v = begin; v < end; ++v)
+            {
+                const auto first = neighbors.begin() + offsets[label(v)];
+                auto last = first;
+                for (size_t it = rhs.offsets_[v]; it < rhs.offsets_[v + 1]; ++it)
+                    *last++ = static_cast<vertex_t>(label(rhs.neighbors_[it]));
+                if (not labels.empty())
+                    std::sort(first, last);
+            }
+        });
+
+        offsets_ = std::move(offsets);
+        neighbors_ = std::move(neighbors);
+    }
+
+    /* merge staged edges (and new vertices) in CSR, after it const methods are thread safe */
+    void compact() const
+    {
+        if (staged_.empty() and offsets_.size() == vertices_ + 1) return;
+
+        /* staged arcs are grouped by src (counting sort), than every group is sorted */
+        std::vector<size_t> staged_offsets(vertices_ + 1, 0);
+        for (auto&& e : staged_)
+        {
+            ++staged_offsets[e.src + 1];
+            if (symmetric)
+                ++staged_offsets[e.dst + 1];
+        }
+        std::partial_sum(staged_offsets.begin(), staged_offsets.end(), staged_offsets.begin());
+
+        std::vector<vertex_t> staged(staged_offsets.back());
+        {
+            std::vector<size_t> next(staged_offsets.begin(), staged_offsets.end() - 1);
+            for (auto&& e : staged_)
+            {
+                staged[next[e.src]++] = e.dst;
+                if (symmetric)
+                    staged[next[e.dst]++] = e.src;
+            }
+        }
+
+        /* every row: merge of old sorted row and sorted staged arcs */
+        std::vector<size_t> offsets(vertices_ + 1, 0);
+        for (size_t v = 0; v < vertices_; ++v)
+        {
+            const size_t old_size = (v + 1 < offsets_.size()) ? offsets_[v + 1] - offsets_[v] : 0;
+            offsets[v + 1] = offsets[v] + old_size + (staged_offsets[v + 1] - staged_offsets[v]);
+        }
+
+        std::vector<vertex_t> neighbors(offsets.back());
+        for (size_t v = 0; v < vertices_; ++v)
+        {
+            auto staged_begin = staged.begin() + staged_offsets[v], staged_end = staged.begin() + staged_offsets[v + 1];
+            std::sort(staged_begin, staged_end);
+
+            auto out = neighbors.begin() + offsets[v];
+            if (v + 1 < offsets_.size())
+                std::merge(neighbors_.begin() + offsets_[v], neighbors_.begin() + offsets_[v + 1],
+                           staged_begin, staged_end, out);
+            else
+                std::copy(staged_begin, staged_end, out);
+        }
+
+        offsets_ = std::move(offsets);
+        neighbors_ = std::move(neighbors);
+        dropStaged();
+    }
+
+    size_t nVertices() const { return vertices_; }
+    size_t nEdges() const { return edges_; }
+    bool contains(vertex_t v) const { return v < vertices_; }
+
+    vertex_t addVertex() { return static_cast<vertex_t>(vertices_++); }
+
+    /* replace graph by vertices and arcs in any order: loops and repeated arcs are dropped, CSR is built directly.
+       for symmetric adjacency arcs must have both directions */
+    template <typename edge_vertex_t>
+    void assign(size_t vertices, const std::vector<BasicEdge<edge_vertex_t>> &arcs)
+    {
+        std::vector<size_t> offsets(vertices + 1, 0);
+        for (auto&& arc : arcs)
+            ++offsets[arc.src + 1];
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        std::vector<vertex_t> neighbors(offsets.back());
+        {
+            std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+            for (auto&& arc : arcs)
+                neighbors[next[arc.src]++] = static_cast<vertex_t>(arc.dst);
+        }
+
+        /* sort and dedupe rows, than shift them left */
+        size_t size = 0;
+        for (size_t v = 0; v < vertices; ++v)
+        {
+            auto begin = neighbors.begin() + offsets[v], end = neighbors.begin() + offsets[v + 1];
+            std::sort(begin, end);
+            end = std::unique(begin, end);
+            end = std::remove(begin, end, static_cast<vertex_t>(v));
+
+            offsets[v] = size;
+            size = std::copy(begin, end, neighbors.begin() + size) - neighbors.begin();
+        }
+        offsets[vertices] = size;
+        neighbors.resize(size);
+        neighbors.shrink_to_fit();
+
+        vertices_ = vertices;
+        edges_ = symmetric ? size / 2 : size;
+        offsets_ = std::move(offsets);
+        neighbors_ = std::move(neighbors);
+        dropStaged();
+    }
+
+    /* false, if edge is already there (vertices are not checked) */
+    bool addEdge(vertex_t src, vertex_t dst)
+    {
+        if (compactedHas(src, dst) or not staged_index_.insert(key(src, dst))) return false;
+
+        staged_.push_back({src, dst});
+        ++edges_;
+        return true;
+    }
+
+    /* O(1) for staged edges, O(log degree) for merged, without merge */
+    bool has(vertex_t src, vertex_t dst) const
+    { return compactedHas(src, dst) or staged_index_.contains(key(src, dst)); }
+
+    /* sorted neighbors, span is valid till the next addVertex/addEdge.
+       while there are staged edges, every read looks for patch of row in hash map,
+       so whole graph passes (traversals, SCC, degrees) call compact() first */
+    std::span<const vertex_t> neighbors(vertex_t v) const
+    {
+        if (not contains(v))
+            throw std::runtime_error("No vertex " + std::to_string(v) + " in graph.");
+
+        if (staged_.size() * merge_ratio >= vertices_ + neighbors_.size())
+            compact();
+        if (not staged_.empty())
+            if (const Patch *patch = this->patch(v))
+                return patch->row;
+        return compactedRow(v);
+    }
+
+    /* arcs reversed by one counting sort pass: sources are visited in order, so rows are sorted */
+    Adjacency transposed() const
+    {
+        compact();
+
+        std::vector<size_t> offsets(vertices_ + 1, 0);
+        for (auto&& u : neighbors_)
+            ++offsets[u + 1];
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        std::vector<vertex_t> neighbors(neighbors_.size());
+        std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+        for (size_t v = 0; v < vertices_; ++v)
+            for (size_t it = offsets_[v]; it < offsets_[v + 1]; ++it)
+                neighbors[next[neighbors_[it]]++] = static_cast<vertex_t>(v);
+
+        Adjacency result;
+        result.vertices_ = vertices_;
+        result.edges_ = edges_;
+        result.offsets_ = std::move(offsets);
+        result.neighbors_ = std::move(neighbors);
+        return result;
+    }
+
+    /* CSR arrays to binary file of graph */
+    void write(FileWriter &file) const
+    {
+        compact();
+        file.write<size_t>(offsets_);
+        file.write<vertex_t>(neighbors_);
+    }
+
+    /* CSR arrays from mapped file: only their sizes are checked here, validate() checks the rest */
+    void read(FileReader &file, size_t vertices, size_t edges)
+    {
+        Array<size_t> offsets = file.read<size_t>(vertices + 1);
+        if (offsets.front() != 0 or offsets.back() != (symmetric ? 2 * edges : edges))
+            throw std::runtime_error("Broken graph file: offsets do not match quantity of edges.");
+
+        neighbors_ = file.read<vertex_t>(offsets.back());
+        offsets_ = std::move(offsets);
+        vertices_ = vertices;
+        edges_ = edges;
+        dropStaged();
+    }
+
+    /* same vertices and same edges (type of vertices is not important) */
+    template <typename other_t>
+    bool operator==(const Adjacency<other_t, symmetric> &rhs) const
+    {
+        compact();
+        rhs.compact();
+        return vertices_ == rhs.vertices_ and offsets_ == rhs.offsets_ and std::ranges::equal(neighbors_, rhs.neighbors_);
+    }
+
+    /* invariants of CSR, std::runtime_error on violation */
+    void validate() const
+    {
+        compact();
+
+        if (offsets_.size() != vertices_ + 1 or offsets_.front() != 0 or offsets_.back() != neighbors_.size())
+            throw std::runtime_error("Broken graph: offsets do not match neighbors.");
+
+        if (not std::is_sorted(offsets_.begin(), offsets_.end()))
+            throw std::runtime_error("Broken graph: offsets are not monotonic.");
+
+        for (size_t v = 0; v < vertices_; ++v)
+            for (size_t it = offsets_[v]; it < offsets_[v + 1]; ++it)
+            {
+                const vertex_t u = neighbors_[it];
+                if (not contains(u) or u == v)
+                    throw std::runtime_error("Broken graph: bad neighbor " + std::to_string(u) + " of " + std::to_string(v));
+                if (it > offsets_[v] and neighbors_[it - 1] >= u)
+                    throw std::runtime_error("Broken graph: neighbors of " + std::to_string(v) + " are not sorted or repeated.");
+                if (symmetric and not compactedHas(u, v))
+                    throw std::runtime_error("Broken graph: edges are not symmetric.");
+            }
+
+        if (neighbors_.size() != (symmetric ? 2 * edges_ : edges_))
+            throw std::runtime_error("Broken graph: quantity of edges does not match.");
+    }
+};
+
+/* stored vertices in new order of relabeling */
+template <typename vertex_t, bool symmetric>
+std::vector<uint64_t> relabelingOrder(const Adjacency<vertex_t, symmetric> &adjacency, Relabeling relabeling)
+{
+    const size_t n = adjacency.nVertices();
+    adjacency.compact();
+    auto&& degree = [&](uint64_t v) { return adjacency.neighbors(static_cast<vertex_t>(v)).size(); };
+    auto&& by_degree = [&](uint64_t lhs, uint64_t rhs) { return degree(lhs) < degree(rhs); };
+
+    std::vector<uint64_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    if (relabeling == DEGREE)
+    {
+        std::stable_sort(order.begin(), order.end(), [&](uint64_t lhs, uint64_t rhs) { return by_degree(rhs, lhs); });
+        return order;
+    }
+
+    /* BFS from unvisited vertex of min degree, children are queued by increasing degree */
+    std::stable_sort(order.begin(), order.end(), by_degree);
+    std::vector<bool> visited(n, false);
+    std::vector<uint64_t> bfs;
+    bfs.reserve(n);
+    for (auto&& start : order)
+    {
+        if (visited[start]) continue;
+
+        visited[start] = true;
+        bfs.push_back(start);
+        for (size_t head = bfs.size() - 1; head < bfs.size(); ++head)
+        {
+            const size_t children = bfs.size();
+            for (auto&& u : adjacency.neighbors(static_cast<vertex_t>(bfs[head])))
+                if (not visited[u])
+                {
+                    visited[u] = true;
+                    bfs.push_back(u);
+                }
+            std::stable_sort(bfs.begin() + children, bfs.end(), by_degree);
+        }
+    }
+
+    std::reverse(bfs.begin(), bfs.end());
+    return bfs;
+}
+
+/* class Row
+    neighbors of vertex as vertices of graph: stored row of 32 or 64-bit vertices, renamed by labels (see CompactAdjacency).
+    values are computed by iterator, so it is random access range of values, not contiguous one
+*/
+template <typename vertex_t>
+class Row : public std::ranges::view_interface<Row<vertex_t>>
+{
+  public:
+    class Iterator
+    {
+      private:
+        const uint32_t *narrow_ = nullptr;
+        const vertex_t *wide_ = nullptr;
+        std::span<const vertex_t> labels_;
+        std::ptrdiff_t index_ = 0;
+
+      public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag; /* operator* returns value, so it is not legacy forward iterator */
+        using value_type = vertex_t;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+        Iterator(const uint32_t *narrow, const vertex_t *wide, std::span<const vertex_t> labels, std::ptrdiff_t index)
+          : narrow_(narrow), wide_(wide), labels_(labels), index_(index)
+        {}
+
+        vertex_t operator[](difference_type offset) const
+        {
+            const vertex_t u = (narrow_ != nullptr) ? narrow_[index_ + offset] : wide_[index_ + offset];
+            return u < labels_.size() ? labels_[u] : u;
+        }
+        vertex_t operator*() const { return (*this)[0]; }
+
+        Iterator &operator++() { ++index_; return *this; }
+        Iterator &operator--() { --index_; return *this; }
+        Iterator operator++(int) { Iterator old = *this; ++index_; return old; }
+        Iterator operator--(int) { Iterator old = *this; --index_; return old; }
+        Iterator &operator+=(difference_type offset) { index_ += offset; return *this; }
+        Iterator &operator-=(difference_type offset) { index_ -= offset; return *this; }
+
+        friend Iterator operator+(Iterator it, difference_type offset) { return it += offset; }
+        friend Iterator operator+(difference_type offset, Iterator it) { return it += offset; }
+        friend Iterator operator-(Iterator it, difference_type offset) { return it -= offset; }
+        friend difference_type operator-(const Iterator &lhs, const Iterator &rhs) { return lhs.index_ - rhs.index_; }
+
+        bool operator==(const Iterator &rhs) const { return index_ == rhs.index_; }
+        auto operator<=>(const Iterator &rhs) const { return index_ <=> rhs.index_; }
+    };
+
+  private:
+    const uint32_t *narrow_ = nullptr;
+    const vertex_t *wide_ = nullptr;
+    size_t size_ = 0;
+    std::span<const vertex_t> labels_;
+
+  public:
+    Row() = default;
+    Row(const uint32_t *narrow, const vertex_t *wide, size_t size, std::span<const vertex_t> labels)
+      : narrow_(narrow), wide_(wide), size_(size), labels_(labels)
+    {}
+
+    Iterator begin() const { return {narrow_, wide_, labels_, 0}; }
+    Iterator end() const { return {narrow_, wide_, labels_, static_cast<std::ptrdiff_t>(size_)}; }
+};
+
+/* class CompactAdjacency
+    Adjacency of graph with vertices of vertex_t, which stores 32-bit vertices, while there are less than 2^32 of them
+    (addVertex widens it), so traversals read half of memory. algorithms get stored Adjacency by visit.
+    stored vertices can be relabeled for locality: v is stored as internal(v), stored i is external(i).
+    labels are permutation of the first vertices, vertices added after relabel keep their ids
+*/
+template <typename vertex_t, bool symmetric>
+class CompactAdjacency
+{
+  public:
+    static constexpr bool narrowable = sizeof(vertex_t) > sizeof(uint32_t);
+
+    using Wide = Adjacency<vertex_t, symmetric>;
+    using Narrow = Adjacency<uint32_t, symmetric>;
+
+  private:
+    /* max of uint32_t is empty slot of EdgeSet, so it cannot be vertex */
+    static constexpr size_t narrow_vertices = std::numeric_limits<uint32_t>::max();
+    static constexpr size_t wide_index = narrowable ? 1 : 0;
+
+    std::conditional_t<narrowable, std::variant<Narrow, Wide>, std::variant<Wide>> adjacency_;
+    Array<vertex_t> internal_;
+    Array<vertex_t> external_;
+
+  public:
+    template <typename visitor_t>
+    decltype(auto) visit(visitor_t &&visitor) const { return std::visit(std::forward<visitor_t>(visitor), adjacency_); }
+
+    /* stored Adjacency of type adjacency_t (std::bad_variant_access, if it is other) */
+    template <typename adjacency_t>
+    const adjacency_t &as() const { return std::get<adjacency_t>(adjacency_); }
+
+    bool relabeled() const { return internal_.size() != 0; }
+    vertex_t internal(vertex_t v) const { return v < internal_.size() ? internal_[v] : v; }
+    vertex_t external(vertex_t v) const { return v < external_.size() ? external_[v] : v; }
+
+    /* per stored vertex values -> per vertex values */
+    template <typename value_t>
+    std::vector<value_t> toExternal(std::vector<value_t> values) const
+    {
+        if (not relabeled()) return values;
+
+        std::vector<value_t> result(values.size());
+        for (size_t v = 0; v < values.size(); ++v)
+            result[v] = values[internal(v)];
+        return result;
+    }
+
+    /* bytes of stored vertex */
+    uint32_t vertexSize() const
+    { return visit([](auto &adjacency) { return uint32_t{sizeof(typename std::decay_t<decltype(adjacency)>::Vertex)}; }); }
+
+    size_t nVertices() const { return visit([](auto &adjacency) { return adjacency.nVertices(); }); }
+    size_t nEdges() const { return visit([](auto &adjacency) { return adjacency.nEdges(); }); }
+    bool contains(vertex_t v) const { return v < nVertices(); }
+    void compact() const { visit([](auto &adjacency) { adjacency.compact(); }); }
+
+    vertex_t addVertex()
+    {
+        if constexpr (narrowable)
+            if (adjacency_.index() == 0 and nVertices() >= narrow_vertices)
+            {
+                Wide wide(std::get<0>(adjacency_), {});
+                adjacency_ = std::move(wide);
+            }
+
+        const vertex_t v = std::visit([](auto &adjacency) -> vertex_t { return adjacency.addVertex(); }, adjacency_);
+        return external(v);
+    }
+
+    /* false, if edge is already there (vertices are not checked) */
+    bool addEdge(vertex_t src, vertex_t dst)
+    { return std::visit([&](auto &adjacency) { return adjacency.addEdge(internal(src), internal(dst)); }, adjacency_); }
+
+    bool has(vertex_t src, vertex_t dst) const
+    { return visit([&](auto &adjacency) { return adjacency.has(internal(src), internal(dst)); }); }
+
+    /* neighbors of v as vertices of graph, view is valid till the next change. they are sorted, if graph is not relabeled */
+    Row<vertex_t> neighbors(vertex_t v) const
+    {
+        if (not contains(v))
+            throw std::runtime_error("No vertex " + std::to_string(v) + " in graph.");
+
+        const uint32_t *narrow = nullptr;
+        const vertex_t *wide = nullptr;
+        size_t size = 0;
+        visit([&](auto &adjacency)
+        {
+            const auto row = adjacency.neighbors(internal(v));
+            size = row.size();
+            if constexpr (std::is_same_v<std::decay_t<decltype(adjacency)>, Wide>)
+                wide = row.data();
+            else
+                narrow = row.data();
+        });
+
+        return Row<vertex_t>(narrow, wide, size, external_);
+    }
+
+    /* replace graph (see Adjacency::assign), it is narrow, if it can be */
+    void assign(size_t vertices, const std::vector<BasicEdge<vertex_t>> &arcs)
+    {
+        if (narrowable and vertices < narrow_vertices)
+            adjacency_.template emplace<0>().assign(vertices, arcs);
+        else
+            adjacency_.template emplace<wide_index>().assign(vertices, arcs);
+        internal_ = {};
+        external_ = {};
+    }
+
+    /* stored vertices are renamed, so vertices in order are neighbors in memory */
+    void relabel(Relabeling relabeling)
+    {
+        const size_t n = nVertices();
+        const std::vector<uint64_t> order = visit([&](auto &adjacency) { return relabelingOrder(adjacency, relabeling); });
+
+        std::vector<uint64_t> position(n);
+        for (size_t it = 0; it < n; ++it)
+            position[order[it]] = it;
+        std::visit([&](auto &adjacency) { adjacency = std::decay_t<decltype(adjacency)>(adjacency, position); }, adjacency_);
+
+        std::vector<vertex_t> internal(n), external(n);
+        for (size_t v = 0; v < n; ++v)
+        {
+            internal[v] = static_cast<vertex_t>(position[this->internal(static_cast<vertex_t>(v))]);
+            external[internal[v]] = static_cast<vertex_t>(v);
+        }
+        internal_ = std::move(internal);
+        external_ = std::move(external);
+    }
+
+    /* arcs reversed, labels are the same */
+    CompactAdjacency transposed() const
+    {
+        CompactAdjacency result;
+        visit([&](auto &adjacency) { result.adjacency_ = adjacency.transposed(); });
+        result.internal_ = internal_;
+        result.external_ = external_;
+        return result;
+    }
+
+    /* CSR of stored vertices, than labels of all vertices, if graph is relabeled (see FileHeader) */
+    void write(FileWriter &file) const
+    {
+        visit([&](auto &adjacency) { adjacency.write(file); });
+        if (not relabeled()) return;
+
+        const size_t n = nVertices();
+        std::vector<vertex_t> internal(n), external(n);
+        for (size_t v = 0; v < n; ++v)
+        {
+            internal[v] = this->internal(static_cast<vertex_t>(v));
+            external[v] = this->external(static_cast<vertex_t>(v));
+        }
+        file.write<vertex_t>(internal);
+        file.write<vertex_t>(external);
+    }
+
+    void read(FileReader &file)
+    {
+        const FileHeader &header = file.header();
+        if (narrowable and header.vertex_size == sizeof(uint32_t))
+            adjacency_.template emplace<0>().read(file, header.vertices, header.edges);
+        else if (header.vertex_size == sizeof(vertex_t))
+            adjacency_.template emplace<wide_index>().read(file, header.vertices, header.edges);
+        else
+            throw std::runtime_error("Graph file has vertices of " + std::to_string(header.vertex_size) + " bytes.");
+
+        internal_ = {};
+        external_ = {};
+        if (header.flags & FileHeader::relabeled)
+        {
+            internal_ = file.read<vertex_t>(header.vertices);
+            external_ = file.read<vertex_t>(header.vertices);
+        }
+    }
+
+    /* CSR invariants and labels are permutation */
+    void validate() const
+    {
+        visit([](auto &adjacency) { adjacency.validate(); });
+
+        if (internal_.size() != external_.size() or internal_.size() > nVertices())
+            throw std::runtime_error("Broken graph: labels do not match vertices.");
+        for (size_t v = 0; v < internal_.size(); ++v)
+            if (internal_[v] >= internal_.size() or external_[internal_[v]] != v)
+                throw std::runtime_error("Broken graph: labels are not permutation.");
+    }
+
+    /* same vertices and same edges (stored type and labels are not important) */
+    bool operator==(const CompactAdjacency &rhs) const
+    {
+        if (nVertices() != rhs.nVertices() or nEdges() != rhs.nEdges()) return false;
+        if (not relabeled() and not rhs.relabeled())
+            return std::visit([](auto &lhs, auto &rhs) { return lhs == rhs; }, adjacency_, rhs.adjacency_);
+
+        std::vector<vertex_t> lhs_row, rhs_row;
+        auto&& sorted_row = [](const CompactAdjacency &adjacency, vertex_t v, std::vector<vertex_t> &row)
+        {
+            const auto neighbors = adjacency.neighbors(v);
+            row.assign(neighbors.begin(), neighbors.end());
+            std::sort(row.begin(), row.end());
+        };
+        for (size_t v = 0; v < nVertices(); ++v)
+        {
+            sorted_row(*this, static_cast<vertex_t>(v), lhs_row);
+            sorted_row(rhs, static_cast<vertex_t>(v), rhs_row);
+            if (lhs_row != rhs_row) return false;
+        }
+        return true;
+    }
+};
+
+/* class ConcurrentUnionFind
+    lock-free disjoint set union: root with greater index is linked to smaller one by CAS, so there are no cycles
+    and root of set is its minimal element. find does path halving, lost CAS of halving is not important.
+    relaxed atomics are enough: parent only decreases, and results are read after join of workers
+*/
+template <typename vertex_t>
+class ConcurrentUnionFind
+{
+  private:
+    std::vector<std::atomic<vertex_t>> parent_;
+
+  public:
+    explicit ConcurrentUnionFind(size_t size) : parent_(size)
+    {
+        parallelFor(size, [this](size_t begin, size_t end)
+        {
+            for (size_t v = begin; v < end; ++v)
+                parent_[v].store(static_cast<vertex_t>(v), std::memory_order_relaxed);
+        });
+    }
+
+    vertex_t find(vertex_t v)
+    {
+        for (;;)
+        {
+            vertex_t parent = parent_[v].load(std::memory_order_relaxed);
+            if (parent == v) return v;
+
+            const vertex_t grandparent = parent_[parent].load(std::memory_order_relaxed);
+            if (grandparent != parent)
+                parent_[v].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+            v = grandparent;
+        }
+    }
+
+    void unite(vertex_t a, vertex_t b)
+    {
+        for (;;)
+        {
+            a = find(a);
+            b = find(b);
+            if (a == b) return;
+
+            if (a < b) std::swap(a, b);
+            vertex_t expected = a;
+            if (parent_[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) return;
+        }
+    }
+};
+
+/* connected components of symmetric adjacency: component id of every vertex, ids are dense [0, count)
+   and are ordered by minimal vertex of component.
+   Afforest: vertices are united with first neighbors, than the largest component is found by sampling,
+   and only vertices out of it unite with the rest neighbors (edge to it is processed from other end) */
+template <typename vertex_t>
+std::vector<uint64_t> connectedComponents(const Adjacency<vertex_t, true> &adjacency, size_t &count)
+{
+    static constexpr size_t sampled_neighbors = 2;
+    static constexpr size_t samples = 1024;
+
+    const size_t n = adjacency.nVertices();
+    adjacency.compact();
+    ConcurrentUnionFind<vertex_t> sets(n);
+
+    for (size_t round = 0; round < sampled_neighbors; ++round)
+        parallelFor(n, [&](size_t begin, size_t end)
+        {
+            for (size_t v = begin; v < end; ++v)
+                if (const auto row = adjacency.neighbors(static_cast<vertex_t>(v)); round < row.size())
+                    sets.unite(static_cast<vertex_t>(v), row[round]);
+        });
+
+    /* the most frequent root of samples (LCG, so result is deterministic) */
+    vertex_t largest = 0;
+    if (n != 0)
+    {
+        std::vector<vertex_t> roots;
+        roots.reserve(samples);
+        for (uint64_t it = 0, state = 1; it < samples; ++it)
+        {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            roots.push_back(sets.find(static_cast<vertex_t>((state >> 33) % n)));
+        }
+
+        std::sort(roots.begin(), roots.end());
+        size_t best = 0;
+        for (size_t it = 0, run = 0; it < roots.size(); ++it)
+        {
+            run = (it != 0 and roots[it] == roots[it - 1]) ? run + 1 : 1;
+            if (run > best) { best = run; largest = roots[it]; }
+        }
+    }
+
+    parallelFor(n, [&](size_t begin, size_t end)
+    {
+        for (size_t v = begin; v < end; ++v)
+        {
+            if (sets.find(static_cast<vertex_t>(v)) == largest) continue;
+            const auto row = adjacency.neighbors(static_cast<vertex_t>(v));
+            for (size_t it = sampled_neighbors; it < row.size(); ++it)
+                sets.unite(static_cast<vertex_t>(v), row[it]);
+        }
+    });
+
+    /* roots of blocks -> prefix sums -> dense ids of roots, than ids of other vertices */
+    const size_t blocks = (n + parallel_block - 1) / parallel_block;
+    std::vector<size_t> first_id(blocks + 1, 0);
+    parallelFor(n, [&](size_t begin, size_t end)
+    {
+        for (size_t v = begin; v < end; ++v)
+            first_id[begin / parallel_block + 1] += (sets.find(static_cast<vertex_t>(v)) == v);
+    });
+    std::partial_sum(first_id.begin(), first_id.end(), first_id.begin());
+    count = first_id.back();
+
+    std::vector<uint64_t> ids(n);
+    parallelFor(n, [&](size_t begin, size_t end)
+    {
+        size_t id = first_id[begin / parallel_block];
+        for (size_t v = begin; v < end; ++v)
+            if (sets.find(static_cast<vertex_t>(v)) == v)
+                ids[v] = id++;
+    });
+    parallelFor(n, [&](size_t begin, size_t end)
+    {
+        for (size_t v = begin; v < end; ++v)
+            if (const vertex_t root = sets.find(static_cast<vertex_t>(v)); root != v)
+                ids[v] = ids[root];
+    });
+
+    return ids;
+}
+
+/* labels (any ids of components) -> dense ids, ordered by minimal vertex of component, so all SCC algorithms
+   give the same result */
+template <typename vertex_t>
+std::vector<vertex_t> denseLabels(std::vector<vertex_t> labels, size_t &count)
+{
+    static constexpr vertex_t no_id = std::numeric_limits<vertex_t>::max();
+
+    std::vector<vertex_t> dense(labels.size(), no_id);
+    count = 0;
+    for (auto&& label : labels)
+    {
+        if (dense[label] == no_id)
+            dense[label] = static_cast<vertex_t>(count++);
+        label = dense[label];
+    }
+    return labels;
+}
+
+/* strongly connected components: Tarjan with explicit stack of frames (vertex, next neighbor) */
+template <typename vertex_t>
+std::vector<vertex_t> strongComponents(const Adjacency<vertex_t, false> &adjacency, size_t &count)
+{
+    static constexpr vertex_t no_index = std::numeric_limits<vertex_t>::max();
+
+    const size_t n = adjacency.nVertices();
+    adjacency.compact();
+    std::vector<vertex_t> index(n, no_index), low(n), labels(n);
+    std::vector<bool> on_stack(n, false);
+    std::vector<vertex_t> component; /* vertices of not finished components */
+    std::vector<std::pair<vertex_t, size_t>> frames;
+    vertex_t timer = 0, components = 0;
+
+    auto&& enter = [&](vertex_t v)
+    {
+        index[v] = low[v] = timer++;
+        component.push_back(v);
+        on_stack[v] = true;
+        frames.push_back({v, 0});
+    };
+
+    for (vertex_t root = 0; root < n; ++root)
+    {
+        if (index[root] != no_index) continue;
+
+        enter(root);
+        while (not frames.empty())
+        {
+            auto &[v, next] = frames.back();
+            const std::span<const vertex_t> row = adjacency.neighbors(v);
+
+            if (next < row.size())
+            {
+                const vertex_t u = row[next++];
+                if (index[u] == no_index)
+                    enter(u); /* v and next are invalid now */
+                else if (on_stack[u])
+                    low[v] = std::min(low[v], index[u]);
+                continue;
+            }
+
+            const vertex_t finished = v;
+            frames.pop_back();
+
+            if (low[finished] == index[finished])
+            {
+                vertex_t u;
+                do
+                {
+                    u = component.back();
+                    component.pop_back();
+                    on_stack[u] = false;
+                    labels[u] = components;
+                } while (u != finished);
+                ++components;
+            }
+
+            if (not frames.empty())
+                low[frames.back().first] = std::min(low[frames.back().first], low[finished]);
+        }
+    }
+
+    return denseLabels(std::move(labels), count);
+}
+
+/* strongly connected components in parallel, in - transposed adjacency:
+    trimming - vertex without active incoming or outgoing arcs is SCC itself;
+    forward-backward - SCC of pivot (vertex of max degree, most likely in giant SCC) = forward reach & backward reach;
+    coloring - max vertex id is propagated by arcs, vertex r with color r is root,
+               backward reach of r by vertices of color r is SCC of r; repeated, while there are active vertices */
+template <typename vertex_t>
+std::vector<vertex_t> parallelStrongComponents(const Adjacency<vertex_t, false> &adjacency,
+                                               const Adjacency<vertex_t, false> &in, size_t &count)
+{
+    static constexpr vertex_t no_label = std::numeric_limits<vertex_t>::max();
+    static constexpr int trim_rounds = 3;
+
+    const size_t n = adjacency.nVertices();
+    adjacency.compact();
+    in.compact();
+
+    std::vector<std::atomic<vertex_t>> labels(n), colors(n);
+    parallelFor(n, [&](size_t begin, size_t end)
+    {
+        for (size_t v = begin; v < end; ++v)
+            labels[v].store(no_label, std::memory_order_relaxed);
+    });
+
+    auto&& active = [&](vertex_t v) { return labels[v].load(std::memory_order_relaxed) == no_label; };
+    auto&& any_active = [&](std::span<const vertex_t> row)
+    { return std::any_of(row.begin(), row.end(), [&](vertex_t u) { return active(u); }); };
+
+    auto&& trim = [&]
+    {
+        for (int round = 0; round < trim_rounds; ++round)
+        {
+            std::atomic<bool> changed{false};
+            parallelFor(n, [&](size_t begin, size_t end)
+            {
+                for (size_t it = begin; it < end; ++it)
+                {
+                    const vertex_t v = static_cast<vertex_t>(it);
+                    if (not active(v) or (any_active(adjacency.neighbors(v)) and any_active(in.neighbors(v)))) continue;
+
+                    labels[v].store(v, std::memory_order_relaxed);
+                    changed.store(true, std::memory_order_relaxed);
+                }
+            });
+            if (not changed) return;
+        }
+    };
+
+    /* level synchronous BFS by active vertices (and by color, if it is given), returns visited flags */
+    auto&& reach = [&](vertex_t source, auto &&row, vertex_t color)
+    {
+        std::vector<std::atomic<bool>> visited(n);
+        std::vector<vertex_t> frontier{source}, next;
+        std::mutex next_mutex;
+        visited[source].store(true, std::memory_order_relaxed);
+
+        while (not frontier.empty())
+        {
+            next.clear();
+            parallelFor(frontier.size(), [&](size_t begin, size_t end)
+            {
+                std::vector<vertex_t> found;
+                for (size_t it = begin; it < end; ++it)
+                    for (auto&& u : row(frontier[it]))
+                        if (active(u) and (color == no_label or colors[u].load(std::memory_order_relaxed) == color) and
+                            not visited[u].exchange(true, std::memory_order_relaxed))
+                            found.push_back(u);
+
+                std::lock_guard lock{next_mutex};
+                next.insert(next.end(), found.begin(), found.end());
+            });
+            frontier.swap(next);
+        }
+        return visited;
+    };
+
+    auto&& out_row = [&](vertex_t v) { return adjacency.neighbors(v); };
+    auto&& in_row = [&](vertex_t v) { return in.neighbors(v); };
+
+    trim();
+
+    /* forward-backward from pivot */
+    vertex_t pivot = no_label;
+    for (size_t v = 0, best = 0; v < n; ++v)
+    {
+        const size_t degree = adjacency.neighbors(static_cast<vertex_t>(v)).size() + in.neighbors(static_cast<vertex_t>(v)).size();
+        if (active(static_cast<vertex_t>(v)) and (pivot == no_label or degree > best))
+        {
+            pivot = static_cast<vertex_t>(v);
+            best = degree;
+        }
+    }
+
+    if (pivot != no_label)
+    {
+        const auto forward = reach(pivot, out_row, no_label);
+        const auto backward = reach(pivot, in_row, no_label);
+        parallelFor(n, [&](size_t begin, size_t end)
+        {
+            for (size_t v = begin; v < end; ++v)
+                if (forward[v].load(std::memory_order_relaxed) and backward[v].load(std::memory_order_relaxed))
+                    labels[v].store(pivot, std::memory_order_relaxed);
+        });
+    }
+
+    /* coloring */
+    for (;;)
+    {
+        trim();
+
+        std::vector<vertex_t> rest;
+        for (size_t v = 0; v < n; ++v)
+            if (active(static_cast<vertex_t>(v)))
+                rest.push_back(static_cast<vertex_t>(v));
+        if (rest.empty()) break;
+
+        parallelFor(rest.size(), [&](size_t begin, size_t end)
+        {
+            for (size_t it = begin; it < end; ++it)
+                colors[rest[it]].store(rest[it], std::memory_order_relaxed);
+        });
+
+        for (std::atomic<bool> changed{true}; changed.exchange(false);)
+            parallelFor(rest.size(), [&](size_t begin, size_t end)
+            {
+                for (size_t it = begin; it < end; ++it)
+                {
+                    const vertex_t color = colors[rest[it]].load(std::memory_order_relaxed);
+                    for (auto&& u : adjacency.neighbors(rest[it]))
+                    {
+                        if (not active(u)) continue;
+
+                        vertex_t current = colors[u].load(std::memory_order_relaxed);
+                        while (current < color and not colors[u].compare_exchange_weak(current, color, std::memory_order_relaxed))
+                        {}
+                        if (current < color)
+                            changed.store(true, std::memory_order_relaxed);
+                    }
+                }
+            });
+
+        std::vector<vertex_t> roots;
+        for (auto&& v : rest)
+            if (colors[v].load(std::memory_order_relaxed) == v)
+                roots.push_back(v);
+
+        /* components of different colors do not intersect, so their labels are set in parallel */
+        parallelFor(roots.size(), [&](size_t begin, size_t end)
+        {
+            std::vector<vertex_t> queue;
+            for (size_t it = begin; it < end; ++it)
+            {
+                const vertex_t root = roots[it];
+                labels[root].store(root, std::memory_order_relaxed);
+                queue.assign(1, root);
+                while (not queue.empty())
+                {
+                    const vertex_t v = queue.back();
+                    queue.pop_back();
+                    for (auto&& u : in.neighbors(v))
+                        if (active(u) and colors[u].load(std::memory_order_relaxed) == root)
+                        {
+                            labels[u].store(root, std::memory_order_relaxed);
+                            queue.push_back(u);
+                        }
+                }
+            }
+        });
+    }
+
+    std::vector<vertex_t> result(n);
+    for (size_t v = 0; v < n; ++v)
+        result[v] = labels[v].load(std::memory_order_relaxed);
+    return denseLabels(std::move(result), count);
+}
+
+/* text edge list: "vertices edges" line, than "src dst" lines, path == nullptr - stdout */
+template <typename graph_t, typename predicate_t>
+void dumpEdges(const graph_t &graph, const char *path, predicate_t &&print)
+{
+    std::ofstream file;
+    if (path != nullptr)
+    {
+        file.open(path);
+        if (not file)
+            throw std::runtime_error("Cannot open '" + std::string(path) + "' to dump graph.");
+    }
+    std::ostream &out = (path != nullptr) ? file : std::cout;
+
+    out << graph.nVertices() << ' ' << graph.nEdges() << '\n';
+    for (typename graph_t::Vertex src = 0; src < graph.nVertices(); ++src)
+        for (auto&& dst : graph.getAdjuscent(src))
+            if (print(src, dst))
+                out << src << ' ' << dst << '\n';
+
+    out.flush();
+    if (not out)
+        throw std::runtime_error("Cannot dump graph.");
+}
+
+} /* namespace detail */
+
+//------------------------------------------------------------------------------------------------------------
+
+/* class PlainGraph
+    undirected graph without loops and multiple edges over CSR (see detail::CompactAdjacency).
+    connectivity is maintained by addVertex/addEdge, so quantity of components and forest/tree checks are O(1),
+    other results of whole graph queries are cached till the next addVertex/addEdge
+*/
 template <typename T>
 class PlainGraph
 {
   public:
-        
+    using Vertex = T;
+    using Edge = BasicEdge<Vertex>;
+
+  private:
+    static constexpr Vertex no_vertex = std::numeric_limits<Vertex>::max();
+
+    /* result of low-link DFS */
+    struct Cuts
+    {
+        bool valid = false;
+        std::vector<Edge> bridges;
+        std::vector<Vertex> articulation_points;
+    };
+
+    /* dense ids of components */
+    struct Components
+    {
+        bool valid = false;
+        size_t count = 0;
+        detail::Array<uint64_t> ids;
+    };
+
+    /* union-find (union by rank) of all vertices, quantity of components and cycle flag, they are updated by
+       addVertex/addEdge. paths are compressed only by changes, so queries do not write to valid union-find.
+       bulk changes (addEdges, load) drop it, than it is rebuilt by one full pass on the next query,
+       so const queries are not thread safe after them (see detail::Adjacency) */
+    struct Connectivity
+    {
+        bool valid = true;
+        size_t count = 0;
+        bool cycle = false;
+        std::vector<Vertex> parent;
+        std::vector<uint8_t> rank;
+    };
+
+    detail::CompactAdjacency<Vertex, true> adjacency_;
+    mutable Cuts cuts_;
+    mutable Components components_;
+    mutable Connectivity connectivity_;
+
+    void invalidate()
+    {
+        cuts_.valid = false;
+        components_.valid = false;
+    }
+
+    void dropConnectivity()
+    {
+        connectivity_.valid = false;
+        connectivity_.parent = {};
+        connectivity_.rank = {};
+    }
+
+    /* root of union-find tree, O(log V) by union by rank */
+    Vertex root(Vertex v) const
+    {
+        while (connectivity_.parent[v] != v)
+            v = connectivity_.parent[v];
+        return v;
+    }
+
+    /* union of components of edge u-v with path compression, edge inside component closes cycle */
+    void join(Vertex u, Vertex v)
+    {
+        if (not connectivity_.valid) return;
+
+        std::vector<Vertex> &parent = connectivity_.parent;
+        auto&& compress = [&](Vertex x)
+        {
+            const Vertex r = root(x);
+            while (parent[x] != r)
+                x = std::exchange(parent[x], r);
+            return r;
+        };
+
+        Vertex a = compress(u), b = compress(v);
+        if (a == b)
+        {
+            connectivity_.cycle = true;
+            return;
+        }
+
+        if (connectivity_.rank[a] < connectivity_.rank[b]) std::swap(a, b);
+        parent[b] = a;
+        if (connectivity_.rank[a] == connectivity_.rank[b]) ++connectivity_.rank[a];
+        --connectivity_.count;
+    }
+
+    /* dense ids from union-find without traversal of graph, or by full parallel pass, if union-find is dropped */
+    void findComponents() const
+    {
+        if (components_.valid) return;
+
+        if (not connectivity_.valid)
+        {
+            std::vector<uint64_t> ids = adjacency_.visit([&](auto &adjacency)
+            { return detail::connectedComponents(adjacency, components_.count); });
+            if (adjacency_.relabeled())
+                ids = detail::denseLabels(adjacency_.toExternal(std::move(ids)), components_.count);
+            components_.ids = std::move(ids);
+        }
+        else
+        {
+            static constexpr uint64_t no_id = std::numeric_limits<uint64_t>::max();
+
+            const size_t n = nVertices();
+            std::vector<uint64_t> ids(n), root_ids(n, no_id);
+            components_.count = 0;
+            for (Vertex v = 0; v < n; ++v)
+            {
+                uint64_t &id = root_ids[root(v)];
+                if (id == no_id) id = components_.count++;
+                ids[v] = id;
+            }
+            components_.ids = std::move(ids);
+        }
+        components_.valid = true;
+    }
+
+    /* union-find from dense ids: every vertex is linked to the minimal vertex of its component */
+    void findConnectivity() const
+    {
+        if (connectivity_.valid) return;
+        findComponents();
+
+        const size_t n = nVertices();
+        std::vector<Vertex> roots(components_.count, no_vertex);
+        connectivity_.parent.resize(n);
+        connectivity_.rank.assign(n, 0);
+        for (Vertex v = 0; v < n; ++v)
+        {
+            const uint64_t id = components_.ids[v];
+            if (id >= components_.count)
+                throw std::runtime_error("Broken graph: component id " + std::to_string(id) + " of " + std::to_string(v));
+
+            if (roots[id] == no_vertex)
+                roots[id] = v;
+            else
+                connectivity_.rank[roots[id]] = 1;
+            connectivity_.parent[v] = roots[id];
+        }
+
+        connectivity_.count = components_.count;
+        connectivity_.cycle = nEdges() + components_.count != n;
+        connectivity_.valid = true;
+    }
+
+    /* bridges and articulation points by one DFS with explicit stack (graph can have 10^7 vertices in path)
+       over stored vertices, results are renamed to vertices of graph.
+       low[v] - min entry time, reachable from subtree of v by one back edge */
+    void findCuts() const
+    {
+        if (cuts_.valid) return;
+
+        adjacency_.compact();
+        const size_t n = nVertices();
+        std::vector<Vertex> entry(n, no_vertex), low(n), parent(n, no_vertex);
+        std::vector<bool> is_articulation(n, false);
+
+        /* frame: vertex and position of next neighbor */
+        std::vector<std::pair<Vertex, size_t>> stack;
+        Vertex timer = 0;
+
+        cuts_.bridges.clear();
+        adjacency_.visit([&](auto &adjacency)
+        {
+            for (Vertex root = 0; root < n; ++root)
+            {
+                if (entry[root] != no_vertex) continue;
+
+                size_t root_children = 0;
+                entry[root] = low[root] = timer++;
+                stack.push_back({root, 0});
+
+                while (not stack.empty())
+                {
+                    auto &[v, next] = stack.back();
+                    const auto row = adjacency.neighbors(v);
+
+                    if (next < row.size())
+                    {
+                        const Vertex u = row[next++];
+                        if (u == parent[v]) continue; /* no multiple edges, so it is the tree edge */
+
+                        if (entry[u] != no_vertex)
+                        {
+                            low[v] = std::min(low[v], entry[u]);
+                            continue;
+                        }
+
+                        parent[u] = v;
+                        entry[u] = low[u] = timer++;
+                        stack.push_back({u, 0}); /* v and next are invalid now */
+                        continue;
+                    }
+
+                    const Vertex child = v;
+                    stack.pop_back();
+                    if (stack.empty()) break;
+
+                    const Vertex p = stack.back().first;
+                    low[p] = std::min(low[p], low[child]);
+
+                    if (low[child] > entry[p])
+                    {
+                        const Vertex a = adjacency_.external(p), b = adjacency_.external(child);
+                        cuts_.bridges.push_back({std::min(a, b), std::max(a, b)});
+                    }
+
+                    if (p == root)
+                        ++root_children;
+                    else if (low[child] >= entry[p])
+                        is_articulation[p] = true;
+                }
+
+                if (root_children >= 2)
+                    is_articulation[root] = true;
+            }
+        });
+
+        std::sort(cuts_.bridges.begin(), cuts_.bridges.end(), [](const Edge &lhs, const Edge &rhs)
+                  { return std::tie(lhs.src, lhs.dst) < std::tie(rhs.src, rhs.dst); });
+
+        cuts_.articulation_points.clear();
+        for (Vertex v = 0; v < n; ++v)
+            if (is_articulation[adjacency_.internal(v)])
+                cuts_.articulation_points.push_back(v);
+
+        cuts_.valid = true;
+    }
+
   public:
+    /* graph from binary file of dump(path): arrays are mapped, not parsed, so it is loaded in O(1) */
+    static PlainGraph load(const char *path)
+    {
+        detail::FileReader file(path);
+        const detail::FileHeader &header = file.header();
+        if (not (header.flags & detail::FileHeader::symmetric))
+            throw std::runtime_error("'" + std::string(path) + "' is not file of undirected graph.");
+
+        PlainGraph graph;
+        graph.adjacency_.read(file);
+        if (header.flags & detail::FileHeader::components)
+        {
+            graph.components_.ids = file.read<uint64_t>(header.vertices);
+            graph.components_.count = header.components_size;
+            graph.components_.valid = true;
+        }
+        graph.dropConnectivity();
+        return graph;
+    }
+
+    Vertex addVertex()
+    {
+        invalidate();
+        const Vertex v = adjacency_.addVertex();
+        if (connectivity_.valid)
+        {
+            connectivity_.parent.push_back(v);
+            connectivity_.rank.push_back(0);
+            ++connectivity_.count;
+        }
+        return v;
+    }
+
+    /* false, if there is no such vertices, u == v or edge is already there */
+    bool addEdge(Vertex u, Vertex v)
+    {
+        if (not adjacency_.contains(u) or not adjacency_.contains(v) or u == v) return false;
+        if (not adjacency_.addEdge(u, v)) return false;
+
+        invalidate();
+        join(u, v);
+        return true;
+    }
+
+    /* bulk load: edges are added as by addEdge, but connectivity is not maintained,
+       it is rebuilt by one parallel pass on the next query. returns quantity of added edges */
+    size_t addEdges(std::span<const Edge> edges)
+    {
+        size_t added = 0;
+        for (auto&& e : edges)
+            if (adjacency_.contains(e.src) and adjacency_.contains(e.dst) and e.src != e.dst and adjacency_.addEdge(e.src, e.dst))
+                ++added;
+
+        if (added != 0)
+        {
+            invalidate();
+            dropConnectivity();
+        }
+        return added;
+    }
+
+    size_t nVertices() const { return adjacency_.nVertices(); }
+    size_t nEdges() const { return adjacency_.nEdges(); }
+
+    bool has(const Edge &e) const
+    { return adjacency_.contains(e.src) and adjacency_.contains(e.dst) and adjacency_.has(e.src, e.dst); }
+
+    /* neighbors of v, view is valid till the next addVertex/addEdge/relabel. they are sorted, if graph is not relabeled */
+    auto getAdjuscent(Vertex v) const { return adjacency_.neighbors(v); }
+
+    size_t nJointComponents() const
+    {
+        findConnectivity();
+        return connectivity_.count;
+    }
+
+    /* u and v are in the same component, O(log V) */
+    bool isConnected(Vertex u, Vertex v) const
+    {
+        if (not adjacency_.contains(u) or not adjacency_.contains(v)) return false;
+
+        findConnectivity();
+        return root(u) == root(v);
+    }
+
+    /* id of component of every vertex, ids are [0, nJointComponents()) in order of minimal vertices of components */
+    std::span<const uint64_t> getJointComponents() const
+    {
+        findComponents();
+        return components_.ids;
+    }
+
+    /* graph without cycles: no edge was added inside its component */
+    bool isForest() const
+    {
+        findConnectivity();
+        return not connectivity_.cycle;
+    }
+
+    bool isTree() const { return isForest() and nJointComponents() == 1; }
+
+    /* edges {src < dst}, sorted, which removal increases quantity of components */
+    std::span<const Edge> getBridges() const
+    {
+        findCuts();
+        return cuts_.bridges;
+    }
 
+    /* sorted vertices, which removal increases quantity of components */
+    std::span<const Vertex> getArticulationPoints() const
+    {
+        findCuts();
+        return cuts_.articulation_points;
+    }
+
+    /* vertices are renamed in memory for locality of traversals, vertices of graph and cached results are the same */
+    void relabel(Relabeling relabeling) { adjacency_.relabel(relabeling); }
+
+    /* CSR invariants and symmetry of arcs, std::runtime_error on violation */
+    void validate() const { adjacency_.validate(); }
+
+    /* path == nullptr - every edge once as text to stdout, else binary file for load (with components, if they are known) */
+    void dump(const char *path) const
+    {
+        if (path == nullptr)
+            return detail::dumpEdges(*this, path, [](Vertex src, Vertex dst) { return src < dst; });
+
+        const uint32_t flags = detail::FileHeader::symmetric | (components_.valid ? detail::FileHeader::components : 0u) |
+                               (adjacency_.relabeled() ? detail::FileHeader::relabeled : 0u);
+        detail::FileWriter file(path, flags, adjacency_.vertexSize(), nVertices(), nEdges(), components_.valid ? components_.count : 0);
+        adjacency_.write(file);
+        if (components_.valid)
+            file.write<uint64_t>(components_.ids);
+        file.commit();
+    }
+
+    /* caches are not compared */
+    bool operator==(const PlainGraph &rhs) const { return adjacency_ == rhs.adjacency_; }
 };
 
+//------------------------------------------------------------------------------------------------------------
+
+/* class DirectionalGraph
+    directed graph without loops and multiple arcs over CSR (see detail::CompactAdjacency):
+    getAdjuscent(v) - heads of arcs from v.
+    degrees and topological order are cached till the next addVertex/addEdge
+*/
 class DirectionalGraph
 {
+  public:
+    using Vertex = uint64_t;
+    using Edge = BasicEdge<Vertex>;
+
+  private:
+    /* graphs with less vertices are condensed serially */
+    static constexpr size_t parallel_threshold = 1 << 16;
+
+    struct Degrees
+    {
+        bool valid = false;
+        std::vector<Vertex> in;
+        std::vector<Vertex> out;
+    };
+
+    /* result of Kahn's algorithm: all vertices, if graph is DAG */
+    struct Order
+    {
+        bool valid = false;
+        std::vector<Vertex> vertices;
+    };
+
+    using Arcs = detail::CompactAdjacency<Vertex, false>;
+
+    /* out-CSR and in-CSR of the same arcs, in-CSR is built on demand and is dropped by mutation.
+       storage is shared by copies and reversed graphs, so it is frozen before sharing (see share)
+       and is not changed while shared (copy on write) */
+    struct Storage
+    {
+        Arcs out;
+        mutable std::optional<Arcs> in;
+    };
+
+    std::shared_ptr<Storage> storage_ = std::make_shared<Storage>();
+    /* graph is transposed storage: its arcs are storage_->in */
+    bool reversed_ = false;
+    mutable Degrees degrees_;
+    mutable Order order_;
+
+    DirectionalGraph(std::shared_ptr<Storage> storage, bool reversed) : storage_(std::move(storage)), reversed_(reversed) {}
+
+    void invalidate()
+    {
+        degrees_.valid = false;
+        order_.valid = false;
+    }
+
+    const Arcs &arcs() const { return reversed_ ? *storage_->in : storage_->out; }
+
+    /* transposed arcs, in-CSR is built once for storage */
+    const Arcs &reversedArcs() const
+    {
+        if (reversed_) return storage_->out;
+        if (not storage_->in)
+            storage_->in = storage_->out.transposed();
+        return *storage_->in;
+    }
+
+    /* storage for copy or reversed graph: both CSR are merged and in-CSR is built before sharing, so const methods
+       of graphs, which share it, never write to it and copies can be read by different threads */
+    const std::shared_ptr<Storage> &share() const
+    {
+        storage_->out.compact();
+        if (storage_->in)
+            storage_->in->compact();
+        else
+            storage_->in = storage_->out.transposed();
+        return storage_;
+    }
+
+    /* copy on write: shared storage is cloned in direction of graph, own reversed storage is swapped */
+    Arcs &mutableArcs()
+    {
+        if (storage_.use_count() > 1)
+        {
+            storage_ = std::make_shared<Storage>(Storage{arcs(), std::nullopt});
+            reversed_ = false;
+        }
+        else if (reversed_)
+        {
+            std::swap(storage_->out, *storage_->in);
+            reversed_ = false;
+        }
+        storage_->in.reset();
+        return storage_->out;
+    }
+
+    /* one pass for in and out degrees */
+    void countDegrees() const
+    {
+        if (degrees_.valid) return;
 
+        const size_t n = nVertices();
+        arcs().compact();
+
+        std::vector<std::atomic<Vertex>> in(n);
+        degrees_.out.resize(n);
+        detail::parallelFor(n, [&](size_t begin, size_t end)
+        {
+            for (size_t v = begin; v < end; ++v)
+            {
+                const auto row = arcs().neighbors(v);
+                degrees_.out[v] = row.size();
+                for (auto&& u : row)
+                    in[u].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+
+        degrees_.in.resize(n);
+        detail::parallelFor(n, [&](size_t begin, size_t end)
+        {
+            for (size_t v = begin; v < end; ++v)
+                degrees_.in[v] = in[v].load(std::memory_order_relaxed);
+        });
+
+        degrees_.valid = true;
+    }
+
+    /* Kahn's algorithm by levels: vertices of frontier release their heads in parallel,
+       heads, which lose the last incoming arc, are the next frontier (sorted, so order is deterministic).
+       graph is DAG, if all vertices are released */
+    void sortTopologically() const
+    {
+        if (order_.valid) return;
+        countDegrees();
+
+        const size_t n = nVertices();
+        std::vector<std::atomic<Vertex>> remaining(n);
+        detail::parallelFor(n, [&](size_t begin, size_t end)
+        {
+            for (size_t v = begin; v < end; ++v)
+                remaining[v].store(degrees_.in[v], std::memory_order_relaxed);
+        });
+
+        std::vector<Vertex> frontier, next;
+        for (Vertex v = 0; v < n; ++v)
+            if (degrees_.in[v] == 0)
+                frontier.push_back(v);
+
+        std::mutex next_mutex;
+        order_.vertices.clear();
+        order_.vertices.reserve(n);
+        while (not frontier.empty())
+        {
+            order_.vertices.insert(order_.vertices.end(), frontier.begin(), frontier.end());
+
+            next.clear();
+            detail::parallelFor(frontier.size(), [&](size_t begin, size_t end)
+            {
+                std::vector<Vertex> released;
+                for (size_t it = begin; it < end; ++it)
+                    for (auto&& u : arcs().neighbors(frontier[it]))
+                        if (remaining[u].fetch_sub(1, std::memory_order_relaxed) == 1)
+                            released.push_back(u);
+
+                std::lock_guard lock{next_mutex};
+                next.insert(next.end(), released.begin(), released.end());
+            });
+
+            std::sort(next.begin(), next.end());
+            frontier.swap(next);
+        }
+
+        order_.valid = true;
+    }
+
+  public:
+    DirectionalGraph() = default;
+
+    /* storage is shared (see share), so copy is O(V + E) only once for graph, than it is O(V) for caches */
+    DirectionalGraph(const DirectionalGraph &rhs)
+      : storage_(rhs.share()), reversed_(rhs.reversed_), degrees_(rhs.degrees_), order_(rhs.order_)
+    {}
+
+    DirectionalGraph &operator=(const DirectionalGraph &rhs)
+    {
+        if (this != &rhs)
+        {
+            storage_ = rhs.share();
+            reversed_ = rhs.reversed_;
+            degrees_ = rhs.degrees_;
+            order_ = rhs.order_;
+        }
+        return *this;
+    }
+
+    /* moved graph is empty (it keeps own storage) */
+    DirectionalGraph(DirectionalGraph &&rhs)
+      : storage_(std::exchange(rhs.storage_, std::make_shared<Storage>())), reversed_(std::exchange(rhs.reversed_, false)),
+        degrees_(std::move(rhs.degrees_)), order_(std::move(rhs.order_))
+    { rhs.invalidate(); }
+
+    DirectionalGraph &operator=(DirectionalGraph &&rhs)
+    {
+        if (this != &rhs)
+        {
+            storage_ = std::exchange(rhs.storage_, std::make_shared<Storage>());
+            reversed_ = std::exchange(rhs.reversed_, false);
+            degrees_ = std::move(rhs.degrees_);
+            order_ = std::move(rhs.order_);
+            rhs.invalidate();
+        }
+        return *this;
+    }
+
+    /* graph from binary file of dump(path): arrays are mapped, not parsed, so it is loaded in O(1) */
+    static DirectionalGraph load(const char *path)
+    {
+        detail::FileReader file(path);
+        const detail::FileHeader &header = file.header();
+        if (header.flags & detail::FileHeader::symmetric)
+            throw std::runtime_error("'" + std::string(path) + "' is not file of directed graph.");
+
+        auto storage = std::make_shared<Storage>();
+        storage->out.read(file);
+        if (header.flags & detail::FileHeader::incoming)
+            storage->in.emplace().read(file);
+        return DirectionalGraph(std::move(storage), false);
+    }
+
+    Vertex addVertex()
+    {
+        invalidate();
+        return mutableArcs().addVertex();
+    }
+
+    /* false, if there is no such vertices, src == dst or arc is already there */
+    bool addEdge(Vertex src, Vertex dst)
+    {
+        if (not arcs().contains(src) or not arcs().contains(dst) or src == dst) return false;
+        /* shared storage is not cloned for repeated arc */
+        if ((storage_.use_count() > 1 or reversed_) and arcs().has(src, dst)) return false;
+        if (not mutableArcs().addEdge(src, dst)) return false;
+
+        invalidate();
+        return true;
+    }
+
+    size_t nVertices() const { return arcs().nVertices(); }
+    size_t nEdges() const { return arcs().nEdges(); }
+
+    bool has(const Edge &e) const
+    { return arcs().contains(e.src) and arcs().contains(e.dst) and arcs().has(e.src, e.dst); }
+
+    /* heads of arcs from v, view is valid till the next addVertex/addEdge/relabel. they are sorted, if graph is not relabeled */
+    auto getAdjuscent(Vertex v) const { return arcs().neighbors(v); }
+
+    /* vertices are renamed in memory for locality of traversals, vertices of graph and cached results are the same */
+    void relabel(Relabeling relabeling) { mutableArcs().relabel(relabeling); }
+
+    /* CSR invariants, std::runtime_error on violation */
+    void validate() const
+    {
+        arcs().validate();
+        if (storage_->in and not (*storage_->in == storage_->out.transposed()))
+            throw std::runtime_error("Broken graph: incoming arcs do not match outgoing ones.");
+    }
+
+    /* path == nullptr - text to stdout, else binary file for load (with incoming arcs, if they are built) */
+    void dump(const char *path) const
+    {
+        if (path == nullptr)
+            return detail::dumpEdges(*this, path, [](Vertex, Vertex) { return true; });
+
+        const bool incoming = reversed_ or storage_->in;
+        const uint32_t flags = (incoming ? detail::FileHeader::incoming : 0u) | (arcs().relabeled() ? detail::FileHeader::relabeled : 0u);
+        detail::FileWriter file(path, flags, arcs().vertexSize(), nVertices(), nEdges(), 0);
+        arcs().write(file);
+        if (incoming)
+            reversedArcs().write(file);
+        file.commit();
+    }
+
+    bool isDAG() const
+    {
+        sortTopologically();
+        return order_.vertices.size() == nVertices();
+    }
+
+    /* all vertices, every arc goes forward; std::runtime_error, if graph has cycle */
+    std::span<const Vertex> topological() const
+    {
+        if (not isDAG())
+            throw std::runtime_error("Graph has cycle, it cannot be sorted topologically.");
+        return order_.vertices;
+    }
+
+    /* vertices without incoming arcs, lazy view over cached degrees, valid till the next addVertex/addEdge */
+    auto getSources() const
+    {
+        countDegrees();
+        return std::views::iota(Vertex{0}, Vertex{nVertices()}) |
+               std::views::filter([in = std::span<const Vertex>(degrees_.in)](Vertex v) { return in[v] == 0; });
+    }
+
+    /* vertices without outgoing arcs, lazy view over cached degrees, valid till the next addVertex/addEdge */
+    auto getSinks() const
+    {
+        countDegrees();
+        return std::views::iota(Vertex{0}, Vertex{nVertices()}) |
+               std::views::filter([out = std::span<const Vertex>(degrees_.out)](Vertex v) { return out[v] == 0; });
+    }
+
+    /* DAG of strongly connected components and component of every vertex,
+       ids of components are ordered by their minimal vertices */
+    std::pair<DirectionalGraph, std::vector<Vertex>> condense() const
+    {
+        size_t components = 0;
+        const bool parallel = nVertices() >= parallel_threshold and std::thread::hardware_concurrency() > 1;
+        std::vector<Vertex> mapping = arcs().visit([&](auto &out)
+        {
+            using adjacency_t = std::decay_t<decltype(out)>;
+            const auto labels = parallel ? detail::parallelStrongComponents(out, reversedArcs().as<adjacency_t>(), components)
+                                         : detail::strongComponents(out, components);
+            return std::vector<Vertex>(labels.begin(), labels.end());
+        });
+        if (arcs().relabeled())
+            mapping = detail::denseLabels(arcs().toExternal(std::move(mapping)), components);
+
+        /* arcs between components, sorted and deduped directly in CSR */
+        std::vector<Edge> arcs;
+        for (Vertex v = 0; v < nVertices(); ++v)
+            for (auto&& u : getAdjuscent(v))
+                if (mapping[v] != mapping[u])
+                    arcs.push_back({mapping[v], mapping[u]});
+
+        DirectionalGraph condensed;
+        condensed.mutableArcs().assign(components, arcs);
+        return {std::move(condensed), std::move(mapping)};
+    }
+
+    /* all arcs reversed, storage is shared (in-CSR is built by the first call), so it is O(V) at most,
+       and it is copied only if one of graphs is changed */
+    DirectionalGraph reverse() const
+    {
+        DirectionalGraph reversed(share(), not reversed_);
+        if (degrees_.valid)
+            reversed.degrees_ = {true, degrees_.out, degrees_.in};
+        return reversed;
+    }
+
+    /* caches and direction of storage are not compared */
+    bool operator==(const DirectionalGraph &rhs) const { return arcs() == rhs.arcs(); }
 };
 
+#if defined(SEBELEV_MAKSIM_MAKSIMOVICH)
+static_assert(traits::PlainGraph<PlainGraph<uint64_t>>, "class PlainGraph must realized PlainGraph interface.");
+static_assert(traits::DirectionalGraph<DirectionalGraph>, "class DirectionalGraph must realized DirectionalGraph interface.");
+#endif /* defined(SEBELEV_MAKSIM_MAKSIMOVICH) */
+
 } /* namespace Graph */
 
 
 /* for contest */
 using namespace Graph;
+
+#if defined(GRAPH_TEST)
+/* copies and reversed graphs share storage, but they are independent values: they are read by different threads
+   (build with -DGRAPH_TEST -fsanitize=thread), while source still has staged arcs */
+int main()
+{
+    using Vertex = DirectionalGraph::Vertex;
+    static constexpr Vertex n = 1 << 12;
+
+    DirectionalGraph graph;
+    for (Vertex v = 0; v < n; ++v)
+        graph.addVertex();
+    for (Vertex v = 0; v < n; ++v)
+        for (Vertex step : {1, 7, 31})
+            graph.addEdge(v, (v * 13 + step) % n);
+
+    const DirectionalGraph copies[] = {graph, graph};
+    std::vector<size_t> arcs(std::size(copies), 0), reversed_arcs(std::size(copies), 0);
+    std::vector<std::thread> readers;
+    for (size_t it = 0; it < std::size(copies); ++it)
+        readers.emplace_back([&, it]
+        {
+            const DirectionalGraph reversed = copies[it].reverse();
+            for (Vertex v = 0; v < n; ++v)
+            {
+                arcs[it] += std::ranges::distance(copies[it].getAdjuscent(v));
+                reversed_arcs[it] += std::ranges::distance(reversed.getAdjuscent(v));
+            }
+        });
+    for (auto&& reader : readers)
+        reader.join();
+
+    for (size_t it = 0; it < std::size(copies); ++it)
+        if (arcs[it] != graph.nEdges() or reversed_arcs[it] != graph.nEdges())
+        {
+            std::cerr << "Copy of graph has " << arcs[it] << " arcs and " << reversed_arcs[it] << " reversed arcs instead of "
+                      << graph.nEdges() << "\n";
+            return 1;
+        }
+    std::cout << "Copies are read concurrently: OK\n";
+    return 0;
+}
+#endif /* defined(GRAPH_TEST) */